@@ -0,0 +1,176 @@
+#define _GNU_SOURCE
+#include <linux/perf_event.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include "ns_ambiqsuite_harness.h"
+#include "ns_perf_profile.h"
+#include "ns_pmu_utils.h"
+
+// neuralSPOT harness calls for the host build: printing, delays, the cycle
+// clock and the DWT/PMU profilers the timing wrappers read.
+
+uint32_t SystemCoreClock = 1000000000u;
+ITM_Type host_itm;
+const ns_core_api_t ns_pmu_current_version = { .apiId = 0xCA000A, .version = 1 };
+
+static DWT_Type dwt;
+
+static uint64_t clock_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+DWT_Type *host_dwt(void)
+{
+  dwt.CYCCNT = (uint32_t)clock_ns();
+  return &dwt;
+}
+
+uint64_t host_cycles64(void) { return clock_ns(); }
+
+void ns_lp_printf(const char *format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  vprintf(format, args);
+  va_end(args);
+}
+
+void ns_delay_us(uint32_t us)
+{
+  struct timespec ts = { .tv_sec = us / 1000000u, .tv_nsec = (long)(us % 1000000u) * 1000 };
+  while (nanosleep(&ts, &ts)) {
+  }
+}
+
+void *ns_malloc(size_t size) { return malloc(size); }
+
+void ns_free(void *ptr) { free(ptr); }
+
+// DWT profiler: cycles only
+void ns_init_perf_profiler(void) {}
+void ns_start_perf_profiler(void) {}
+void ns_stop_perf_profiler(void) {}
+void ns_reset_perf_counters(void) {}
+
+void ns_capture_perf_profiler(ns_perf_counters_t *c)
+{
+  memset(c, 0, sizeof(*c));
+  c->cyccnt = DWT->CYCCNT;
+}
+
+void ns_delta_perf(ns_perf_counters_t *s, ns_perf_counters_t *e, ns_perf_counters_t *d)
+{
+  d->cyccnt = e->cyccnt - s->cyccnt;
+  d->cpicnt = e->cpicnt - s->cpicnt;
+  d->exccnt = e->exccnt - s->exccnt;
+  d->sleepcnt = e->sleepcnt - s->sleepcnt;
+  d->lsucnt = e->lsucnt - s->lsucnt;
+  d->foldcnt = e->foldcnt - s->foldcnt;
+}
+
+// PMU: ARMv8.1-M event ids with a perf equivalent, counted in user space only
+#define HW_CACHE(cache, op, result)                                          \
+  (PERF_COUNT_HW_CACHE_##cache | (PERF_COUNT_HW_CACHE_OP_##op << 8) |        \
+   (PERF_COUNT_HW_CACHE_RESULT_##result << 16))
+
+static const struct {
+  uint16_t id;
+  uint32_t type;
+  uint64_t config;
+} kPerfEvents[] = {
+  { 0x0011, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+  { 0x0008, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+  { 0x0004, PERF_TYPE_HW_CACHE, HW_CACHE(L1D, READ, ACCESS) },
+  { 0x0003, PERF_TYPE_HW_CACHE, HW_CACHE(L1D, READ, MISS) },
+  { 0x0001, PERF_TYPE_HW_CACHE, HW_CACHE(L1I, READ, MISS) },
+  { 0x0021, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS },
+  { 0x0022, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+  { 0x001D, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BUS_CYCLES },
+  { 0x0023, PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_FRONTEND },
+  { 0x0024, PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND },
+};
+#define PERF_EVENT_COUNT (sizeof(kPerfEvents) / sizeof(kPerfEvents[0]))
+
+// The open group: the leader is the first event that opened, read with
+// PERF_FORMAT_GROUP in open order; slot[] maps that order to counter slots
+static int perfFd[NS_PMU_MAX_COUNTERS];
+static uint32_t perfIds[NS_PMU_MAX_COUNTERS];
+static uint32_t perfSlot[NS_PMU_MAX_COUNTERS];
+static uint32_t perfOpen = 0;
+
+static int perf_open(uint32_t id, int group)
+{
+  for (size_t i = 0; i < PERF_EVENT_COUNT; i++) {
+    if (kPerfEvents[i].id != id) continue;
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = kPerfEvents[i].type;
+    attr.config = kPerfEvents[i].config;
+    attr.disabled = group < 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+  }
+  return -1;
+}
+
+static void perf_close(void)
+{
+  for (uint32_t k = perfOpen; k-- > 0;) close(perfFd[k]);
+  perfOpen = 0;
+}
+
+uint32_t ns_pmu_init(ns_pmu_config_t *cfg)
+{
+  uint32_t ids[NS_PMU_MAX_COUNTERS] = { 0 };
+  for (uint32_t i = 0; i < NS_PMU_MAX_COUNTERS; i++) ids[i] = cfg->events[i].enabled ? cfg->events[i].eventId : 0;
+  // Multiplexed re-runs reprogram the same groups over and over: keep an open group
+  if (perfOpen && !memcmp(ids, perfIds, sizeof(ids))) {
+    ns_pmu_reset_counters();
+    return NS_STATUS_SUCCESS;
+  }
+  perf_close();
+  memcpy(perfIds, ids, sizeof(ids));
+  for (uint32_t i = 0; i < NS_PMU_MAX_COUNTERS; i++) {
+    cfg->counter[i].counterValue = 0;
+    if (!cfg->events[i].enabled) continue;
+    int fd = perf_open(cfg->events[i].eventId, perfOpen ? perfFd[0] : -1);
+    if (fd < 0) continue;  // no such event on this CPU: the slot reads 0
+    perfFd[perfOpen] = fd;
+    perfSlot[perfOpen++] = i;
+  }
+  if (!perfOpen) return NS_STATUS_FAILURE;
+  ioctl(perfFd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(perfFd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return NS_STATUS_SUCCESS;
+}
+
+uint32_t ns_pmu_get_counters(ns_pmu_config_t *cfg)
+{
+  uint64_t buf[1 + NS_PMU_MAX_COUNTERS];
+  if (!perfOpen || read(perfFd[0], buf, sizeof(buf)) < (ssize_t)sizeof(uint64_t)) return NS_STATUS_FAILURE;
+  for (uint64_t k = 0; k < buf[0] && k < perfOpen; k++) cfg->counter[perfSlot[k]].counterValue = (uint32_t)buf[1 + k];
+  return NS_STATUS_SUCCESS;
+}
+
+void ns_pmu_reset_counters(void)
+{
+  if (perfOpen) ioctl(perfFd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+}
+
+void ns_delta_pmu(ns_pmu_counters_t *s, ns_pmu_counters_t *e, ns_pmu_counters_t *d)
+{
+  for (int i = 0; i < NS_PMU_MAX_COUNTERS; i++) d->counterValue[i] = e->counterValue[i] - s->counterValue[i];
+}
@@ -0,0 +1,53 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ns_ambiqsuite_harness.h"
+#include "test_library.h"
+
+// Host entry point: run a selection of the test list, or one shard of it, and
+// exit non-zero if any test did not pass. With -i, keep reading commands
+// (selections, "list", "store") from stdin until EOF, as on the device. The
+// QEMU build (qemu/) shares it, with arguments from the semihosting command
+// line; there -i polls the debugger mailbox as on the device.
+//
+//   build/main_host [--select EXPR] [--shard K/N] [-i]
+static void usage(const char *argv0)
+{
+  fprintf(stderr, "usage: %s [--select EXPR] [--shard K/N] [-i]\n", argv0);
+  exit(2);
+}
+
+int main(int argc, char **argv)
+{
+  const char *select = NULL;
+  unsigned shard = 0, shards = 1;
+  int interactive = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--select") && i + 1 < argc) {
+      select = argv[++i];
+    } else if (!strcmp(argv[i], "--shard") && i + 1 < argc) {
+      if (sscanf(argv[++i], "%u/%u", &shard, &shards) != 2 || !shards || shard >= shards) usage(argv[0]);
+    } else if (!strcmp(argv[i], "-i")) {
+      interactive = 1;
+    } else {
+      usage(argv[0]);
+    }
+  }
+
+  // Each shard's log is its own file; keep it whole if the process dies
+  setvbuf(stdout, NULL, _IOLBF, 0);
+
+  if (select) test_library_select(select);
+  test_library_shard(shard, shards);
+  test_library();
+  int failed = test_library_failed();
+
+  while (interactive && !feof(stdin)) {
+    if (test_library_poll()) {
+      test_library();
+      failed = test_library_failed();
+    }
+  }
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
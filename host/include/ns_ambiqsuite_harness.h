@@ -0,0 +1,58 @@
+#ifndef NS_AMBIQSUITE_HARNESS_H
+#define NS_AMBIQSUITE_HARNESS_H
+
+// Host stand-in for the neuralSPOT harness: just what the test runner, the
+// timing wrappers and the aot-unit-test model use. Implemented in
+// host/host_harness.c.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NS_STATUS_SUCCESS 0
+#define NS_STATUS_FAILURE -1
+
+#define NS_PUT_IN_TCM
+#define NS_SRAM_BSS
+
+typedef struct {
+  uint32_t apiId;
+  uint32_t version;
+} ns_core_api_t;
+
+void ns_lp_printf(const char *format, ...) __attribute__((format(printf, 1, 2)));
+void ns_delay_us(uint32_t us);
+
+// Cycle clock behind the wrappers: CLOCK_MONOTONIC in nanoseconds, so one
+// "cycle" of DWT->CYCCNT is 1 ns and SystemCoreClock is 1 GHz. Core cycles
+// proper come from the CPU_CYCLES PMU event (perf_event_open).
+extern uint32_t SystemCoreClock;
+
+typedef struct {
+  volatile uint32_t CYCCNT;
+} DWT_Type;
+DWT_Type *host_dwt(void);
+#define DWT (host_dwt())
+
+// The same clock at full width. A 32-bit CYCCNT in nanoseconds wraps every
+// 4.3 s, so kernel_cycles_now() reads this instead of extending CYCCNT.
+uint64_t host_cycles64(void);
+#define HOST_CYCLES64() host_cycles64()
+
+// No trace port: the ITM never reports busy
+typedef struct {
+  volatile uint32_t TCR;
+} ITM_Type;
+extern ITM_Type host_itm;
+#define ITM (&host_itm)
+#define ITM_TCR_BUSY_Msk (1UL << 23)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NS_AMBIQSUITE_HARNESS_H
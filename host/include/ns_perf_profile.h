@@ -0,0 +1,34 @@
+#ifndef NS_PERF_PROFILE_H
+#define NS_PERF_PROFILE_H
+
+// Host stand-in for neuralSPOT's DWT profiler. Only cyccnt counts (the
+// nanosecond clock behind DWT->CYCCNT); there is no CPI, exception, sleep,
+// LSU or fold counter on a host, so those read 0.
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  uint32_t cyccnt;
+  uint32_t cpicnt;
+  uint32_t exccnt;
+  uint32_t sleepcnt;
+  uint32_t lsucnt;
+  uint32_t foldcnt;
+} ns_perf_counters_t;
+
+void ns_init_perf_profiler(void);
+void ns_start_perf_profiler(void);
+void ns_stop_perf_profiler(void);
+void ns_reset_perf_counters(void);
+void ns_capture_perf_profiler(ns_perf_counters_t *c);
+void ns_delta_perf(ns_perf_counters_t *s, ns_perf_counters_t *e, ns_perf_counters_t *d);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NS_PERF_PROFILE_H
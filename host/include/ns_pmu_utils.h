@@ -0,0 +1,73 @@
+#ifndef NS_PMU_UTILS_H
+#define NS_PMU_UTILS_H
+
+// Host stand-in for neuralSPOT's PMU driver, backed by perf_event_open. Events
+// keep their ARMv8.1-M ids so trace records decode as on the device;
+// host_harness.c maps the ones with an x86 equivalent onto perf events and
+// the rest (MVE, LSU, memory-system stalls) read 0.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ns_ambiqsuite_harness.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NS_PMU_MAX_COUNTERS 8
+
+typedef enum {
+  NS_PMU_EVENT_COUNTER_SIZE_16,
+  NS_PMU_EVENT_COUNTER_SIZE_32,
+} ns_pmu_event_counter_size_e;
+
+typedef struct {
+  bool enabled;
+  uint32_t eventId;
+  ns_pmu_event_counter_size_e counterSize;
+} ns_pmu_event_t;
+
+typedef struct {
+  uint32_t counterValue;
+  bool added;
+} ns_pmu_counter_t;
+
+typedef struct {
+  const ns_core_api_t *api;
+  ns_pmu_event_t events[NS_PMU_MAX_COUNTERS];
+  ns_pmu_counter_t counter[NS_PMU_MAX_COUNTERS];
+} ns_pmu_config_t;
+
+typedef struct {
+  uint32_t counterValue[NS_PMU_MAX_COUNTERS];
+} ns_pmu_counters_t;
+
+extern const ns_core_api_t ns_pmu_current_version;
+
+// Opens the enabled events as one perf group; fails only if none can be opened
+uint32_t ns_pmu_init(ns_pmu_config_t *cfg);
+uint32_t ns_pmu_get_counters(ns_pmu_config_t *cfg);
+void ns_pmu_reset_counters(void);
+void ns_delta_pmu(ns_pmu_counters_t *s, ns_pmu_counters_t *e, ns_pmu_counters_t *d);
+
+// Host catalogue: group 0 holds what x86 counts for every logged call -
+// cycles, instructions, L1D accesses and misses. Same ids as the device list.
+#ifndef KERNEL_PMU_EVENT_LIST
+#define KERNEL_PMU_EVENT_LIST                  \
+  X(CPU_CYCLES, 0x0011)                        \
+  X(INST_RETIRED, 0x0008)                      \
+  X(L1D_CACHE, 0x0004)                         \
+  X(L1D_CACHE_REFILL, 0x0003)                  \
+  X(BR_RETIRED, 0x0021)                        \
+  X(BR_MIS_PRED_RETIRED, 0x0022)               \
+  X(L1I_CACHE_REFILL, 0x0001)                  \
+  X(BUS_CYCLES, 0x001D)                        \
+  X(STALL_FRONTEND, 0x0023)                    \
+  X(STALL_BACKEND, 0x0024)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NS_PMU_UTILS_H
@@ -1,34 +1,71 @@
+# Kernels wrapped with -Wl,--wrap; generated with src/kernel_timing_wrap.c by
+# tools/gen_wrappers.py
+# BEGIN GENERATED kernel list
 WRAP_KERNELS := \
 	arm_add_s16 \
 	arm_add_s8 \
 	arm_avgpool_s16 \
+	arm_avgpool_s16_get_buffer_size \
+	arm_avgpool_s16_get_buffer_size_dsp \
+	arm_avgpool_s16_get_buffer_size_mve \
 	arm_avgpool_s8 \
+	arm_avgpool_s8_get_buffer_size \
+	arm_avgpool_s8_get_buffer_size_dsp \
+	arm_avgpool_s8_get_buffer_size_mve \
 	arm_batch_matmul_s16 \
 	arm_batch_matmul_s8 \
 	arm_convolve_1_x_n_s4 \
+	arm_convolve_1_x_n_s4_get_buffer_size \
 	arm_convolve_1_x_n_s8 \
+	arm_convolve_1_x_n_s8_get_buffer_size \
 	arm_convolve_1x1_s4 \
 	arm_convolve_1x1_s4_fast \
+	arm_convolve_1x1_s4_fast_get_buffer_size \
 	arm_convolve_1x1_s8 \
 	arm_convolve_1x1_s8_fast \
+	arm_convolve_1x1_s8_fast_get_buffer_size \
 	arm_convolve_s16 \
+	arm_convolve_s16_get_buffer_size \
 	arm_convolve_s4 \
+	arm_convolve_s4_get_buffer_size \
 	arm_convolve_s8 \
+	arm_convolve_s8_get_buffer_size \
 	arm_convolve_weight_sum \
 	arm_convolve_weight_sum_s4 \
 	arm_convolve_wrapper_s16 \
+	arm_convolve_wrapper_s16_get_buffer_size \
+	arm_convolve_wrapper_s16_get_buffer_size_dsp \
+	arm_convolve_wrapper_s16_get_buffer_size_mve \
 	arm_convolve_wrapper_s4 \
+	arm_convolve_wrapper_s4_get_buffer_size \
+	arm_convolve_wrapper_s4_get_buffer_size_dsp \
+	arm_convolve_wrapper_s4_get_buffer_size_mve \
 	arm_convolve_wrapper_s8 \
+	arm_convolve_wrapper_s8_get_buffer_size \
+	arm_convolve_wrapper_s8_get_buffer_size_dsp \
+	arm_convolve_wrapper_s8_get_buffer_size_mve \
 	arm_depthwise_conv_3x3_s8 \
 	arm_depthwise_conv_fast_s16 \
+	arm_depthwise_conv_fast_s16_get_buffer_size \
 	arm_depthwise_conv_s16 \
 	arm_depthwise_conv_s4 \
 	arm_depthwise_conv_s4_opt \
+	arm_depthwise_conv_s4_opt_get_buffer_size \
 	arm_depthwise_conv_s8 \
 	arm_depthwise_conv_s8_opt \
+	arm_depthwise_conv_s8_opt_get_buffer_size \
 	arm_depthwise_conv_wrapper_s16 \
+	arm_depthwise_conv_wrapper_s16_get_buffer_size \
+	arm_depthwise_conv_wrapper_s16_get_buffer_size_dsp \
+	arm_depthwise_conv_wrapper_s16_get_buffer_size_mve \
 	arm_depthwise_conv_wrapper_s4 \
+	arm_depthwise_conv_wrapper_s4_get_buffer_size \
+	arm_depthwise_conv_wrapper_s4_get_buffer_size_dsp \
+	arm_depthwise_conv_wrapper_s4_get_buffer_size_mve \
 	arm_depthwise_conv_wrapper_s8 \
+	arm_depthwise_conv_wrapper_s8_get_buffer_size \
+	arm_depthwise_conv_wrapper_s8_get_buffer_size_dsp \
+	arm_depthwise_conv_wrapper_s8_get_buffer_size_mve \
 	arm_depthwise_convolve_weight_sum \
 	arm_depthwise_weight_sum_s4 \
 	arm_elementwise_add_s16 \
@@ -37,8 +74,14 @@ WRAP_KERNELS := \
 	arm_elementwise_mul_s8 \
 	arm_fully_connected_per_channel_s8 \
 	arm_fully_connected_s16 \
+	arm_fully_connected_s16_get_buffer_size \
+	arm_fully_connected_s16_get_buffer_size_dsp \
+	arm_fully_connected_s16_get_buffer_size_mve \
 	arm_fully_connected_s4 \
 	arm_fully_connected_s8 \
+	arm_fully_connected_s8_get_buffer_size \
+	arm_fully_connected_s8_get_buffer_size_dsp \
+	arm_fully_connected_s8_get_buffer_size_mve \
 	arm_fully_connected_wrapper_s8 \
 	arm_hard_swish_compat_s16 \
 	arm_hard_swish_compat_s8 \
@@ -74,14 +117,135 @@ WRAP_KERNELS := \
 	arm_svdf_s8 \
 	arm_svdf_state_s16_s8 \
 	arm_transpose_conv_s8 \
+	arm_transpose_conv_s8_get_buffer_size \
+	arm_transpose_conv_s8_get_reverse_conv_buffer_size \
 	arm_transpose_conv_wrapper_s8 \
+	arm_transpose_conv_wrapper_s8_get_buffer_size \
+	arm_transpose_conv_wrapper_s8_get_buffer_size_dsp \
+	arm_transpose_conv_wrapper_s8_get_buffer_size_mve \
+	arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size \
+	arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size_dsp \
+	arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size_mve \
 	arm_transpose_s16 \
 	arm_transpose_s8 \
 	arm_vector_sum_s4 \
 	arm_vector_sum_s8
+# END GENERATED kernel list
 
 
+# Per-call kernel results: 1 = binary trace ring drained between tests
+# (decode with tools/trace_decode.py), 0 = printed from inside each wrapper
+KERNEL_TRACE_RING ?= 1
+DEFINES += KERNEL_TRACE_RING=$(KERNEL_TRACE_RING)
+
+# Repeat mode: re-run each outermost kernel call up to KERNEL_REPEAT_MAX times
+# (0 = off) until the 95% CI of its cycle count is within KERNEL_REPEAT_CI
+# permille of the mean, and log min/median/p90/p99/mean/stddev
+KERNEL_REPEAT_MAX ?= 0
+KERNEL_REPEAT_CI ?= 10
+DEFINES += KERNEL_REPEAT_MAX=$(KERNEL_REPEAT_MAX) KERNEL_REPEAT_CI=$(KERNEL_REPEAT_CI)
+
+# Cache state per measured call: 0 = as is, 1 = cold (clean+invalidate L1
+# first), 2 = warm (one unmeasured run first), 3 = cold then warm
+KERNEL_CACHE_MODE ?= 0
+DEFINES += KERNEL_CACHE_MODE=$(KERNEL_CACHE_MODE)
+
+# 1 = re-run each outermost kernel call once per remaining PMU event group of
+# KERNEL_PMU_EVENT_LIST (src/kernel_timing_wrap.h) for a complete profile;
+# 0 = only the first group is counted on the logged call
+KERNEL_PMU_MULTIPLEX ?= 0
+DEFINES += KERNEL_PMU_MULTIPLEX=$(KERNEL_PMU_MULTIPLEX)
+
+# Compile-time instrumentation ceiling: NONE (kernels not wrapped), COUNT_ONLY
+# (call counts), CYCLES (+ per-call cycles, shapes, helpers), DWT (+ DWT
+# counters, repeat mode) or FULL_PMU (+ PMU events). Code above it is not built
+KERNEL_TIMING_LEVEL ?= FULL_PMU
+DEFINES += KERNEL_TIMING_LEVEL=KERNEL_TIMING_$(KERNEL_TIMING_LEVEL)
+
+# Instrumentation level every kernel starts at: 0 = off (one branch per call),
+# 1 = call count, 2 = cycles, 3 = + DWT counters, 4 = + PMU events; clamped to
+# KERNEL_TIMING_LEVEL
+KERNEL_LEVEL_DEFAULT ?= 4
+DEFINES += KERNEL_LEVEL_DEFAULT=$(KERNEL_LEVEL_DEFAULT)
+
+# Test runner kernel filter: comma-separated name patterns ('*' wildcard), e.g.
+# KERNEL_FILTER='arm_convolve_*'. Matching kernels run at KERNEL_FILTER_LEVEL,
+# all others are off. Empty = no filter
+KERNEL_FILTER ?=
+KERNEL_FILTER_LEVEL ?= 4
+ifneq ($(KERNEL_FILTER),)
+DEFINES += KERNEL_FILTER=\"$(KERNEL_FILTER)\" KERNEL_FILTER_LEVEL=$(KERNEL_FILTER_LEVEL)
+endif
+
+# CMSIS-NN internal helpers timed inside the public kernels: 1 = cycles and
+# call counts aggregated per helper per wrapped parent call, 0 = not wrapped
+# (always, below KERNEL_TIMING_LEVEL=CYCLES).
+# Generated with KERNEL_HELPER_LIST in src/kernel_timing_wrap.h
+KERNEL_HELPERS ?= 1
+DEFINES += KERNEL_HELPERS=$(KERNEL_HELPERS)
+# BEGIN GENERATED helper list
+WRAP_HELPERS := \
+	arm_nn_depthwise_conv_nt_t_s8 \
+	arm_nn_mat_mul_core_1x_s8 \
+	arm_nn_mat_mul_core_4x_s8 \
+	arm_nn_mat_mult_nt_t_s8 \
+	arm_nn_vec_mat_mult_t_s8
+# END GENERATED helper list
+ifeq ($(KERNEL_HELPERS)$(filter CYCLES DWT FULL_PMU,$(KERNEL_TIMING_LEVEL)),1$(KERNEL_TIMING_LEVEL))
+WRAP_KERNELS += $(WRAP_HELPERS)
+endif
+
+# Per-kernel on-device aggregates (count/sum/min/max/sumsq/log2 histogram),
+# dumped as [STATS] lines when the suite completes. KERNEL_RECORDS=0 drops the
+# per-call records and keeps only these
+KERNEL_STATS ?= 1
+KERNEL_RECORDS ?= 1
+DEFINES += KERNEL_STATS=$(KERNEL_STATS) KERNEL_RECORDS=$(KERNEL_RECORDS)
+
+# 1 = print [LEVEL_BENCH] per-call costs of each instrumentation level at start
+KERNEL_LEVEL_BENCH ?= 0
+DEFINES += KERNEL_LEVEL_BENCH=$(KERNEL_LEVEL_BENCH)
+
+# Tests the first run covers, as a test_library_select() expression: categories
+# (@pooling), name patterns and index ranges, e.g. TEST_SELECT='@pooling,!*param_fail*'.
+# Empty = every test built in. Later runs are selected over the command channel
+TEST_SELECT ?=
+ifneq ($(TEST_SELECT),)
+DEFINES += TEST_SELECT=\"$(TEST_SELECT)\"
+endif
+
+# Watchdog budget per test function in cycles (0 = off). A test that runs over
+# resets the board; the run resumes after it and reports it as TIMEOUT
+TEST_BUDGET_CYCLES ?= 0
+DEFINES += TEST_BUDGET_CYCLES=$(TEST_BUDGET_CYCLES)
+
+# Binary result store in retained SRAM (host builds: RESULT_STORE_FILE), read
+# back with the "store" command and tools/result_store.py
+RESULT_STORE ?= 1
+RESULT_STORE_RECORDS ?= 512
+DEFINES += RESULT_STORE=$(RESULT_STORE) RESULT_STORE_RECORDS=$(RESULT_STORE_RECORDS)
+
+# Inferences aot_ds_cnn_profile (category AOT) runs under the per-operator
+# profiler (src/aot_profile.h) before printing its layer table
+AOT_PROFILE_INFERENCES ?= 10
+DEFINES += AOT_PROFILE_INFERENCES=$(AOT_PROFILE_INFERENCES)
+
+# aot_ds_cnn_benchmark: untimed warm-up inferences, then timed ones (at most
+# AOT_BENCH_MAX_RUNS, 256) for the min/median/p99 latency
+AOT_BENCH_WARMUP ?= 5
+AOT_BENCH_RUNS ?= 100
+DEFINES += AOT_BENCH_WARMUP=$(AOT_BENCH_WARMUP) AOT_BENCH_RUNS=$(AOT_BENCH_RUNS)
+
+# Pacing between tests: wait for the ITM to go idle (at most TEST_PACE_MAX_US),
+# then settle for TEST_SETTLE_US; raise it only if a measurement needs a quiet
+# bus before each test
+TEST_SETTLE_US ?= 0
+TEST_PACE_MAX_US ?= 20000
+DEFINES += TEST_SETTLE_US=$(TEST_SETTLE_US) TEST_PACE_MAX_US=$(TEST_PACE_MAX_US)
+
+ifneq ($(KERNEL_TIMING_LEVEL),NONE)
 LFLAGS += $(foreach S,$(WRAP_KERNELS),-Wl,--wrap=$(S))
+endif
 LFLAGS += -Wl,-Map,$(BINDIR)/link.map
 
 
@@ -4,6 +4,11 @@
 #include <stdint.h>
 #include "arm_nnfunctions.h"
 
+// In place: output may be the input buffer itself (same address, not a
+// partial overlap). Each output pixel is written after its window is read,
+// and with no padding and strides >= 1 no later window starts before it.
+#define AOT_AVERAGE_POOL_9_INPLACE 1
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -14,7 +19,7 @@ int32_t aot_average_pool_9_init(void);
 // Run the operation.
 // @param input  Pointer to the input buffer.
 // @param output Pointer to the output buffer.
-int32_t aot_average_pool_9_run(const int8_t* __restrict input, int8_t* __restrict output);
+int32_t aot_average_pool_9_run(const int8_t* input, int8_t* output);
 
 #ifdef __cplusplus
 }
@@ -4,6 +4,10 @@
 #include <stdint.h>
 #include "arm_nnfunctions.h"
 
+// Not in place: every output pixel reads a window of input pixels across all
+// input channels, so the output may not overlap the input.
+#define AOT_CONV_6_INPLACE 0
+
 #ifdef __cplusplus
 extern "C" {
 #endif
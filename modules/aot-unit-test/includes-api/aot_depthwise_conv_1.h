@@ -4,6 +4,10 @@
 #include <stdint.h>
 #include "arm_nnfunctions.h"
 
+// Not in place: an output pixel's window reaches input pixels that the
+// outputs before it would already have overwritten.
+#define AOT_DEPTHWISE_CONV_1_INPLACE 0
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -4,6 +4,9 @@
 #include <stdint.h>
 #include "arm_nnfunctions.h"
 
+// Not in place: every output reads the whole input vector.
+#define AOT_FULLY_CONNECTED_11_INPLACE 0
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -0,0 +1,24 @@
+#ifndef aot_model_plan_h
+#define aot_model_plan_h
+
+// Activation arena of aot_model.c, generated by tools/aot_plan.py from the
+// operator list and tensor lifetimes (heuristic: greedy by size). Do not edit;
+// rerun the tool after regenerating the model.
+
+#define AOT_PLAN_ARENA_SIZE 16000
+
+// Offset of each operator's output: bytes, and the run steps (operators in
+// call order, from 0) it is live over
+#define AOT_PLAN_CONV_0             0     // 8000 bytes, steps 0-1
+#define AOT_PLAN_DEPTHWISE_CONV_1   8000  // 8000 bytes, steps 1-2
+#define AOT_PLAN_CONV_2             0     // 8000 bytes, steps 2-3
+#define AOT_PLAN_DEPTHWISE_CONV_3   8000  // 8000 bytes, steps 3-4
+#define AOT_PLAN_CONV_4             0     // 8000 bytes, steps 4-5
+#define AOT_PLAN_DEPTHWISE_CONV_5   8000  // 8000 bytes, steps 5-6
+#define AOT_PLAN_CONV_6             0     // 8000 bytes, steps 6-7
+#define AOT_PLAN_DEPTHWISE_CONV_7   8000  // 8000 bytes, steps 7-8
+#define AOT_PLAN_CONV_8             0     // 8000 bytes, steps 8-10
+#define AOT_PLAN_AVERAGE_POOL_9     0     // 64 bytes, steps 9-10, in place over conv_8
+#define AOT_PLAN_FULLY_CONNECTED_11 8000  // 12 bytes, steps 10-11
+
+#endif // aot_model_plan_h
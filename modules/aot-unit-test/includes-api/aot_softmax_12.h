@@ -4,6 +4,11 @@
 #include <stdint.h>
 #include "arm_nnfunctions.h"
 
+// In place: output may be the input buffer itself (same address, not a
+// partial overlap). Each row is read in full for its max and sum before its
+// outputs are written, each at its input's index.
+#define AOT_SOFTMAX_12_INPLACE 1
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -14,7 +19,7 @@ int32_t aot_softmax_12_init(void);
 // Run the operation.
 // @param input  Pointer to the input buffer.
 // @param output Pointer to the output buffer.
-int32_t aot_softmax_12_run(const int8_t* __restrict input, int8_t* __restrict output);
+int32_t aot_softmax_12_run(const int8_t* input, int8_t* output);
 
 #ifdef __cplusplus
 }
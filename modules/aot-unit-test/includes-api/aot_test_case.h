@@ -10,6 +10,17 @@ extern "C" {
 int32_t aot_test_case_init(void);
 int32_t aot_test_case_run(void);
 
+// Init the model, run it inferences times under aot_profile_callback(), check
+// the last outputs and print the per-operator table (src/aot_profile.h)
+int32_t aot_test_case_profile(uint32_t inferences);
+
+// Latency benchmark: time aot_model_init() once and the first inference, then
+// run warmup untimed inferences and time runs more (at most
+// AOT_BENCH_MAX_RUNS). Prints [AOT_BENCH] lines with the init and first
+// latencies and the min/median/p99/max of the timed runs. Outputs are checked
+// after the first and the last inference only; non-zero if either differs.
+int32_t aot_test_case_benchmark(uint32_t warmup, uint32_t runs);
+
 #ifdef __cplusplus
 }
 #endif
@@ -65,7 +65,7 @@ aot_average_pool_9_init(void)
 
 
 int32_t
-aot_average_pool_9_run(const int8_t* __restrict input, int8_t* __restrict output)
+aot_average_pool_9_run(const int8_t* input, int8_t* output)
 {
 
     return arm_avgpool_s8(
@@ -27,6 +27,7 @@
 #include "ns_ambiqsuite_harness.h"
 #include "aot_resource_variables.h"
 #include "aot_model.h"
+#include "aot_model_plan.h"
 #include "aot_conv_0.h"
 #include "aot_depthwise_conv_1.h"
 #include "aot_conv_2.h"
@@ -65,7 +66,7 @@ const float aot_outputs_scale[1] = {
 };
 
 
-alignas(16) static int8_t model_buffer[16000];
+alignas(16) static int8_t model_buffer[AOT_PLAN_ARENA_SIZE];
 
 
 int32_t aot_model_init(aot_model_context_t *context)
@@ -207,7 +208,7 @@ int32_t aot_model_run(aot_model_context_t *context)
     if (context->callback) {
         context->callback(0, aot_model_state_started, status, context->user_data);
     }
-    status = aot_conv_0_run(context->input_data[0], (int8_t *)(buffer + 0));
+    status = aot_conv_0_run(context->input_data[0], (int8_t *)(buffer + AOT_PLAN_CONV_0));
     if (context->callback) {
         context->callback(0, aot_model_state_finished, status, context->user_data);
     }
@@ -217,7 +218,7 @@ int32_t aot_model_run(aot_model_context_t *context)
     if (context->callback) {
         context->callback(1, aot_model_state_started, status, context->user_data);
     }
-    status = aot_depthwise_conv_1_run((int8_t *)(buffer + 0), (int8_t *)(buffer + 8000));
+    status = aot_depthwise_conv_1_run((int8_t *)(buffer + AOT_PLAN_CONV_0), (int8_t *)(buffer + AOT_PLAN_DEPTHWISE_CONV_1));
     if (context->callback) {
         context->callback(1, aot_model_state_finished, status, context->user_data);
     }
@@ -227,7 +228,7 @@ int32_t aot_model_run(aot_model_context_t *context)
     if (context->callback) {
         context->callback(2, aot_model_state_started, status, context->user_data);
     }
-    status = aot_conv_2_run((int8_t *)(buffer + 8000), (int8_t *)(buffer + 0));
+    status = aot_conv_2_run((int8_t *)(buffer + AOT_PLAN_DEPTHWISE_CONV_1), (int8_t *)(buffer + AOT_PLAN_CONV_2));
     if (context->callback) {
         context->callback(2, aot_model_state_finished, status, context->user_data);
     }
@@ -237,7 +238,7 @@ int32_t aot_model_run(aot_model_context_t *context)
     if (context->callback) {
         context->callback(3, aot_model_state_started, status, context->user_data);
     }
-    status = aot_depthwise_conv_3_run((int8_t *)(buffer + 0), (int8_t *)(buffer + 8000));
+    status = aot_depthwise_conv_3_run((int8_t *)(buffer + AOT_PLAN_CONV_2), (int8_t *)(buffer + AOT_PLAN_DEPTHWISE_CONV_3));
     if (context->callback) {
         context->callback(3, aot_model_state_finished, status, context->user_data);
     }
@@ -247,7 +248,7 @@ int32_t aot_model_run(aot_model_context_t *context)
     if (context->callback) {
         context->callback(4, aot_model_state_started, status, context->user_data);
     }
-    status = aot_conv_4_run((int8_t *)(buffer + 8000), (int8_t *)(buffer + 0));
+    status = aot_conv_4_run((int8_t *)(buffer + AOT_PLAN_DEPTHWISE_CONV_3), (int8_t *)(buffer + AOT_PLAN_CONV_4));
     if (context->callback) {
         context->callback(4, aot_model_state_finished, status, context->user_data);
     }
@@ -257,7 +258,7 @@ int32_t aot_model_run(aot_model_context_t *context)
     if (context->callback) {
         context->callback(5, aot_model_state_started, status, context->user_data);
     }
-    status = aot_depthwise_conv_5_run((int8_t *)(buffer + 0), (int8_t *)(buffer + 8000));
+    status = aot_depthwise_conv_5_run((int8_t *)(buffer + AOT_PLAN_CONV_4), (int8_t *)(buffer + AOT_PLAN_DEPTHWISE_CONV_5));
     if (context->callback) {
         context->callback(5, aot_model_state_finished, status, context->user_data);
     }
@@ -267,7 +268,7 @@ int32_t aot_model_run(aot_model_context_t *context)
     if (context->callback) {
         context->callback(6, aot_model_state_started, status, context->user_data);
     }
-    status = aot_conv_6_run((int8_t *)(buffer + 8000), (int8_t *)(buffer + 0));
+    status = aot_conv_6_run((int8_t *)(buffer + AOT_PLAN_DEPTHWISE_CONV_5), (int8_t *)(buffer + AOT_PLAN_CONV_6));
     if (context->callback) {
         context->callback(6, aot_model_state_finished, status, context->user_data);
     }
@@ -277,7 +278,7 @@ int32_t aot_model_run(aot_model_context_t *context)
     if (context->callback) {
         context->callback(7, aot_model_state_started, status, context->user_data);
     }
-    status = aot_depthwise_conv_7_run((int8_t *)(buffer + 0), (int8_t *)(buffer + 8000));
+    status = aot_depthwise_conv_7_run((int8_t *)(buffer + AOT_PLAN_CONV_6), (int8_t *)(buffer + AOT_PLAN_DEPTHWISE_CONV_7));
     if (context->callback) {
         context->callback(7, aot_model_state_finished, status, context->user_data);
     }
@@ -287,7 +288,7 @@ int32_t aot_model_run(aot_model_context_t *context)
     if (context->callback) {
         context->callback(8, aot_model_state_started, status, context->user_data);
     }
-    status = aot_conv_8_run((int8_t *)(buffer + 8000), (int8_t *)(buffer + 0));
+    status = aot_conv_8_run((int8_t *)(buffer + AOT_PLAN_DEPTHWISE_CONV_7), (int8_t *)(buffer + AOT_PLAN_CONV_8));
     if (context->callback) {
         context->callback(8, aot_model_state_finished, status, context->user_data);
     }
@@ -297,7 +298,7 @@ int32_t aot_model_run(aot_model_context_t *context)
     if (context->callback) {
         context->callback(9, aot_model_state_started, status, context->user_data);
     }
-    status = aot_average_pool_9_run((int8_t *)(buffer + 0), (int8_t *)(buffer + 8000));
+    status = aot_average_pool_9_run((int8_t *)(buffer + AOT_PLAN_CONV_8), (int8_t *)(buffer + AOT_PLAN_AVERAGE_POOL_9));
     if (context->callback) {
         context->callback(9, aot_model_state_finished, status, context->user_data);
     }
@@ -307,7 +308,7 @@ int32_t aot_model_run(aot_model_context_t *context)
     if (context->callback) {
         context->callback(11, aot_model_state_started, status, context->user_data);
     }
-    status = aot_fully_connected_11_run((int8_t *)(buffer + 8000), (int8_t *)(buffer + 0));
+    status = aot_fully_connected_11_run((int8_t *)(buffer + AOT_PLAN_AVERAGE_POOL_9), (int8_t *)(buffer + AOT_PLAN_FULLY_CONNECTED_11));
     if (context->callback) {
         context->callback(11, aot_model_state_finished, status, context->user_data);
     }
@@ -317,7 +318,7 @@ int32_t aot_model_run(aot_model_context_t *context)
     if (context->callback) {
         context->callback(12, aot_model_state_started, status, context->user_data);
     }
-    status = aot_softmax_12_run((int8_t *)(buffer + 0), context->output_data[0]);
+    status = aot_softmax_12_run((int8_t *)(buffer + AOT_PLAN_FULLY_CONNECTED_11), context->output_data[0]);
     if (context->callback) {
         context->callback(12, aot_model_state_finished, status, context->user_data);
     }
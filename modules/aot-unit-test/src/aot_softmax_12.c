@@ -36,7 +36,7 @@ aot_softmax_12_init(void)
 }
 
 int32_t
-aot_softmax_12_run(const int8_t* __restrict input, int8_t* __restrict output)
+aot_softmax_12_run(const int8_t* input, int8_t* output)
 {
 
     arm_softmax_s8(
@@ -24,6 +24,8 @@
 #include "ns_ambiqsuite_harness.h"
 #include "aot_model.h"
 #include "aot_test_case.h"
+#include "aot_profile.h"
+#include "ns_perf_profile.h"
 
 static int8_t aot_test_stimulus_input_0[490] = {
   84, 85, 85, 83, 84, 84, 84, 84, 83, 83, 84, 83, 84, 84, 83, 84, 83, 84, 83, 83, 
@@ -90,16 +92,10 @@ int32_t aot_test_case_init(void)
     return aot_model_init(&aot_test_stimulus_context);
 }
 
-int32_t aot_test_case_run(void)
+// Compare the outputs of the last run against the golden ones
+static int32_t aot_test_case_check(void)
 {
     int32_t result = 0;
-
-    result = aot_model_run(&aot_test_stimulus_context);
-    if (result != 0) {
-        ns_lp_printf("Model run failed with status %d\n", result);
-        return result;
-    }
-
     for (int j = 0; j < aot_outputs_len[0]; j++) {
         float act = aot_test_stimulus_output_0[j];
         float exp = aot_test_stimulus_golden_0[j];
@@ -109,7 +105,20 @@ int32_t aot_test_case_run(void)
             result = 1;
         }
     }
+    return result;
+}
+
+int32_t aot_test_case_run(void)
+{
+    int32_t result = 0;
+
+    result = aot_model_run(&aot_test_stimulus_context);
+    if (result != 0) {
+        ns_lp_printf("Model run failed with status %d\n", result);
+        return result;
+    }
 
+    result = aot_test_case_check();
 
     if (result == 0) {
         ns_lp_printf("Test passed!\n");
@@ -119,3 +128,157 @@ int32_t aot_test_case_run(void)
     return result;
 
 }
+
+// The model's operators, for the layer table (shapes are output shapes)
+static const aot_profile_op_t aot_test_stimulus_ops[] = {
+    { 0, "CONV_2D", "1x25x5x64", 25 * 5 * 64 * 10 * 4 },
+    { 1, "DEPTHWISE_CONV_2D", "1x25x5x64", 25 * 5 * 64 * 3 * 3 },
+    { 2, "CONV_2D", "1x25x5x64", 25 * 5 * 64 * 64 },
+    { 3, "DEPTHWISE_CONV_2D", "1x25x5x64", 25 * 5 * 64 * 3 * 3 },
+    { 4, "CONV_2D", "1x25x5x64", 25 * 5 * 64 * 64 },
+    { 5, "DEPTHWISE_CONV_2D", "1x25x5x64", 25 * 5 * 64 * 3 * 3 },
+    { 6, "CONV_2D", "1x25x5x64", 25 * 5 * 64 * 64 },
+    { 7, "DEPTHWISE_CONV_2D", "1x25x5x64", 25 * 5 * 64 * 3 * 3 },
+    { 8, "CONV_2D", "1x25x5x64", 25 * 5 * 64 * 64 },
+    { 9, "AVERAGE_POOL_2D", "1x1x1x64", 25 * 5 * 64 },
+    { 11, "FULLY_CONNECTED", "1x12", 64 * 12 },
+    { 12, "SOFTMAX", "1x12", 0 },
+};
+
+static aot_profile_t aot_test_stimulus_profile;
+
+int32_t aot_test_case_profile(uint32_t inferences)
+{
+    int32_t result = aot_model_init(&aot_test_stimulus_context);
+    if (result != 0) {
+        ns_lp_printf("Model init failed with status %d\n", result);
+        return result;
+    }
+
+    // Profile the runs only, not the operators' init
+    aot_profile_init(&aot_test_stimulus_profile, aot_test_stimulus_ops,
+                     sizeof(aot_test_stimulus_ops) / sizeof(aot_test_stimulus_ops[0]));
+    aot_model_context_t context = aot_test_stimulus_context;
+    context.callback = aot_profile_callback;
+    context.user_data = &aot_test_stimulus_profile;
+    for (uint32_t i = 0; i < inferences && result == 0; i++) {
+        result = aot_model_run(&context);
+    }
+    if (result != 0) {
+        ns_lp_printf("Model run failed with status %d\n", result);
+    } else {
+        result = aot_test_case_check();
+    }
+
+    aot_profile_print(&aot_test_stimulus_profile, "aot_test_case");
+    return result;
+}
+
+#ifndef AOT_BENCH_MAX_RUNS
+#define AOT_BENCH_MAX_RUNS 256
+#endif
+
+static uint32_t aot_bench_cycles[AOT_BENCH_MAX_RUNS];
+
+// The --wrap layer, when the test runner links it in: its 64-bit clock and
+// KERNEL_CPU_HZ. Weak, so the module links on its own as well.
+extern void kernel_timing_init(void) __attribute__((weak));
+extern uint64_t kernel_cycles_now(void) __attribute__((weak));
+extern uint32_t kernel_cycles_to_us(uint64_t cycles) __attribute__((weak));
+
+// Start the DWT only if it is not running: ns_init_perf_profiler() zeroes
+// CYCCNT, which kernel_cycles_now() would read as a wrap
+static void aot_bench_init(void)
+{
+    if (kernel_timing_init) {
+        kernel_timing_init();
+        return;
+    }
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+    if (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) return;
+#endif
+    ns_init_perf_profiler();
+    ns_start_perf_profiler();
+}
+
+static uint64_t aot_bench_now(void) { return kernel_cycles_now ? kernel_cycles_now() : DWT->CYCCNT; }
+
+// Cycles since t0: on the 64-bit clock saturated to 32 bits, else modulo CYCCNT
+static uint32_t aot_bench_since(uint64_t t0)
+{
+    if (!kernel_cycles_now) return (uint32_t)(DWT->CYCCNT - (uint32_t)t0);
+    uint64_t cycles = kernel_cycles_now() - t0;
+    return cycles > UINT32_MAX ? UINT32_MAX : (uint32_t)cycles;
+}
+
+static uint32_t aot_bench_us(uint32_t cycles)
+{
+    if (kernel_cycles_to_us) return kernel_cycles_to_us(cycles);
+    return (uint32_t)((uint64_t)cycles * 1000000u / SystemCoreClock);
+}
+
+static int aot_bench_cmp(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+int32_t aot_test_case_benchmark(uint32_t warmup, uint32_t runs)
+{
+    // No operator callback: only the model is inside the timed window
+    aot_model_context_t context = aot_test_stimulus_context;
+    context.callback = NULL;
+    context.user_data = NULL;
+    if (runs > AOT_BENCH_MAX_RUNS) runs = AOT_BENCH_MAX_RUNS;
+
+    aot_bench_init();
+
+    uint64_t t0 = aot_bench_now();
+    int32_t result = aot_model_init(&context);
+    uint32_t init = aot_bench_since(t0);
+    if (result != 0) {
+        ns_lp_printf("Model init failed with status %d\n", result);
+        return result;
+    }
+
+    t0 = aot_bench_now();
+    result = aot_model_run(&context);
+    uint32_t first = aot_bench_since(t0);
+    int32_t first_check = result ? result : aot_test_case_check();
+
+    for (uint32_t i = 0; i < warmup && result == 0; i++) {
+        result = aot_model_run(&context);
+    }
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < runs && result == 0; i++) {
+        t0 = aot_bench_now();
+        result = aot_model_run(&context);
+        aot_bench_cycles[i] = aot_bench_since(t0);
+        sum += aot_bench_cycles[i];
+    }
+    if (result != 0) {
+        ns_lp_printf("Model run failed with status %d\n", result);
+        return result;
+    }
+    int32_t last_check = aot_test_case_check();
+
+    // Nearest-rank percentiles over the measured runs
+    qsort(aot_bench_cycles, runs, sizeof(aot_bench_cycles[0]), aot_bench_cmp);
+    uint32_t min = runs ? aot_bench_cycles[0] : 0;
+    uint32_t median = runs ? aot_bench_cycles[(runs - 1) / 2] : 0;
+    uint32_t p99 = runs ? aot_bench_cycles[(runs * 99 + 99) / 100 - 1] : 0;
+    uint32_t max = runs ? aot_bench_cycles[runs - 1] : 0;
+    uint32_t mean = runs ? (uint32_t)(sum / runs) : 0;
+
+    ns_lp_printf("[AOT_BENCH] init_cycles=%lu init_us=%lu first_cycles=%lu first_us=%lu warmup=%lu runs=%lu\n",
+                 (unsigned long)init, (unsigned long)aot_bench_us(init), (unsigned long)first,
+                 (unsigned long)aot_bench_us(first), (unsigned long)warmup, (unsigned long)runs);
+    ns_lp_printf("[AOT_BENCH] min=%lu median=%lu p99=%lu max=%lu mean=%lu cycles; min_us=%lu median_us=%lu "
+                 "p99_us=%lu max_us=%lu\n",
+                 (unsigned long)min, (unsigned long)median, (unsigned long)p99, (unsigned long)max,
+                 (unsigned long)mean, (unsigned long)aot_bench_us(min), (unsigned long)aot_bench_us(median),
+                 (unsigned long)aot_bench_us(p99), (unsigned long)aot_bench_us(max));
+    ns_lp_printf("[AOT_BENCH] check first=%s last=%s\n", first_check ? "FAIL" : "PASS",
+                 last_check ? "FAIL" : "PASS");
+    return first_check ? first_check : last_check;
+}
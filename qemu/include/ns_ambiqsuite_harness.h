@@ -0,0 +1,58 @@
+#ifndef NS_AMBIQSUITE_HARNESS_H
+#define NS_AMBIQSUITE_HARNESS_H
+
+// QEMU mps3-an547 stand-in for the neuralSPOT harness. Printing goes to Arm
+// semihosting (newlib rdimon) and the cycle clock is SysTick; see qemu/qemu_harness.c. The DWT
+// and PMU profiler headers are shared with the host build (host/include).
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NS_STATUS_SUCCESS 0
+#define NS_STATUS_FAILURE -1
+
+#define NS_PUT_IN_TCM
+#define NS_SRAM_BSS
+
+typedef struct {
+  uint32_t apiId;
+  uint32_t version;
+} ns_core_api_t;
+
+void ns_lp_printf(const char *format, ...) __attribute__((format(printf, 1, 2)));
+void ns_delay_us(uint32_t us);
+
+// QEMU has no DWT: CYCCNT is the 24-bit SysTick extended in software, counting
+// at the board's system clock (QEMU_SYSCLK_HZ). Deterministic per-kernel counts
+// come from the TCG plugin, not from this clock.
+extern uint32_t SystemCoreClock;
+
+typedef struct {
+  volatile uint32_t CYCCNT;
+} DWT_Type;
+DWT_Type *host_dwt(void);
+#define DWT (host_dwt())
+
+// The extended SysTick at full width; CYCCNT is its low 32 bits. kernel_cycles_now()
+// reads this rather than extending CYCCNT a second time.
+uint64_t host_cycles64(void);
+#define HOST_CYCLES64() host_cycles64()
+
+// No trace port: the ITM never reports busy
+typedef struct {
+  volatile uint32_t TCR;
+} ITM_Type;
+extern ITM_Type host_itm;
+#define ITM (&host_itm)
+#define ITM_TCR_BUSY_Msk (1UL << 23)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NS_AMBIQSUITE_HARNESS_H
@@ -0,0 +1,215 @@
+// TCG plugin: deterministic instruction counts per kernel call.
+//
+// Watches the first instruction of kernel_mark() (marker=ADDR, from nm) and
+// reads its op and arg from r0/r1; see KERNEL_MARKERS in
+// src/kernel_timing_wrap.h. Between a kernel's START and END marks, outside
+// any PAUSE/RESUME pair, it counts the instructions executed, those in the MVE
+// (Helium) encoding space, and loads and stores. Each END prints
+//
+//   [QEMU_INSN] test=T seq=S kernel=ID depth=D insns=N mve=N loads=N stores=N
+//
+// to out=FILE (default: QEMU's log). Counts of a nested kernel are included in
+// the kernel that encloses it. tools/qemu_insns.py names and compares them.
+//
+// Needs QEMU 9.0 or later (register reads from plugins).
+
+#include <glib.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <qemu-plugin.h>
+
+QEMU_PLUGIN_EXPORT int qemu_plugin_version = QEMU_PLUGIN_VERSION;
+
+// Mark ops, as kernel_mark_t
+enum { MARK_START = 1, MARK_END = 2, MARK_PAUSE = 3, MARK_RESUME = 4, MARK_TEST = 5 };
+
+#define MAX_DEPTH 32
+
+typedef struct {
+  uint64_t insns, mve, loads, stores;
+} counts_t;
+
+typedef struct {
+  int counting;  // START frame; 0 = PAUSE frame
+  uint32_t kernel;
+  counts_t at;   // totals when the frame was entered
+} frame_t;
+
+typedef struct {
+  int mve;
+  uint64_t lastSeq;  // memory callbacks of one execution count once
+} insn_info_t;
+
+static uint64_t markerAddr;
+static FILE *out;
+static struct qemu_plugin_register *regR0, *regR1;
+
+static frame_t frames[MAX_DEPTH];
+static int depth;
+static counts_t total;
+static uint64_t execSeq;
+static uint32_t testIdx, callSeq;
+
+static inline int counting(void) { return depth > 0 && frames[depth - 1].counting; }
+
+// MVE and the Armv8.1-M FP/vector space: T32 coprocessor encodings 0b111x11xx
+// with coproc 14/15 (MVE uses the old coprocessor space), plus the
+// 0xEFxx/0xFFxx vector data-processing forms and VCTP.
+static int is_mve(uint16_t hw1, uint16_t hw2)
+{
+  if ((hw1 & 0xEF00) == 0xEF00) return 1;
+  if ((hw1 & 0xEC00) == 0xEC00 && (hw2 & 0x0E00) == 0x0E00) return 1;
+  if ((hw1 & 0xFFC0) == 0xF000 && hw2 == 0xE801) return 1;
+  return 0;
+}
+
+static uint32_t read_reg(struct qemu_plugin_register *reg)
+{
+  GByteArray *buf = g_byte_array_new();
+  uint32_t v = 0;
+  if (qemu_plugin_read_register(reg, buf) >= 4) memcpy(&v, buf->data, 4);
+  g_byte_array_free(buf, TRUE);
+  return v;
+}
+
+static void report(const frame_t *f)
+{
+  int nested = 0;  // enclosing kernels, as depth= in the wrapper's own lines
+  for (int i = 0; i < depth; i++) nested += frames[i].counting;
+  char line[192];
+  snprintf(line, sizeof(line),
+           "[QEMU_INSN] test=%" PRIu32 " seq=%" PRIu32 " kernel=%" PRIu32 " depth=%d insns=%" PRIu64
+           " mve=%" PRIu64 " loads=%" PRIu64 " stores=%" PRIu64 "\n",
+           testIdx, callSeq++, f->kernel, nested, total.insns - f->at.insns, total.mve - f->at.mve,
+           total.loads - f->at.loads, total.stores - f->at.stores);
+  if (out) {
+    fputs(line, out);
+  } else {
+    qemu_plugin_outs(line);
+  }
+}
+
+static void on_marker(unsigned int vcpu, void *udata)
+{
+  (void)vcpu;
+  (void)udata;
+  uint32_t op = read_reg(regR0), arg = read_reg(regR1);
+  switch (op) {
+    case MARK_START:
+    case MARK_PAUSE:
+      if (depth == MAX_DEPTH) break;
+      frames[depth] = (frame_t){ .counting = op == MARK_START, .kernel = arg, .at = total };
+      depth++;
+      break;
+    case MARK_END:
+      if (counting()) {
+        depth--;
+        report(&frames[depth]);
+      }
+      break;
+    case MARK_RESUME:
+      if (depth && !frames[depth - 1].counting) depth--;
+      break;
+    case MARK_TEST:
+      testIdx = arg;
+      callSeq = 0;
+      depth = 0;
+      break;
+  }
+}
+
+static void on_exec(unsigned int vcpu, void *udata)
+{
+  (void)vcpu;
+  execSeq++;
+  if (!counting()) return;
+  total.insns++;
+  total.mve += ((const insn_info_t *)udata)->mve;
+}
+
+static void on_mem(unsigned int vcpu, qemu_plugin_meminfo_t info, uint64_t vaddr, void *udata)
+{
+  (void)vcpu;
+  (void)vaddr;
+  insn_info_t *insn = udata;
+  if (!counting() || insn->lastSeq == execSeq) return;
+  insn->lastSeq = execSeq;
+  if (qemu_plugin_mem_is_store(info)) {
+    total.stores++;
+  } else {
+    total.loads++;
+  }
+}
+
+static void on_tb_trans(qemu_plugin_id_t id, struct qemu_plugin_tb *tb)
+{
+  (void)id;
+  size_t n = qemu_plugin_tb_n_insns(tb);
+  for (size_t i = 0; i < n; i++) {
+    struct qemu_plugin_insn *insn = qemu_plugin_tb_get_insn(tb, i);
+    if ((qemu_plugin_insn_vaddr(insn) & ~1ull) == markerAddr) {
+      qemu_plugin_register_vcpu_insn_exec_cb(insn, on_marker, QEMU_PLUGIN_CB_R_REGS, NULL);
+    }
+
+    uint16_t hw[2] = { 0, 0 };
+    qemu_plugin_insn_data(insn, hw, qemu_plugin_insn_size(insn) < 4 ? 2 : 4);
+    // One record per translated instruction; translations live for the whole run
+    insn_info_t *info = g_new0(insn_info_t, 1);
+    info->mve = qemu_plugin_insn_size(insn) == 4 && is_mve(hw[0], hw[1]);
+    info->lastSeq = UINT64_MAX;
+    qemu_plugin_register_vcpu_insn_exec_cb(insn, on_exec, QEMU_PLUGIN_CB_NO_REGS, info);
+    qemu_plugin_register_vcpu_mem_cb(insn, on_mem, QEMU_PLUGIN_CB_NO_REGS, QEMU_PLUGIN_MEM_RW, info);
+  }
+}
+
+static void on_vcpu_init(qemu_plugin_id_t id, unsigned int vcpu)
+{
+  (void)id;
+  (void)vcpu;
+  GArray *regs = qemu_plugin_get_registers();
+  for (guint i = 0; i < regs->len; i++) {
+    qemu_plugin_reg_descriptor *d = &g_array_index(regs, qemu_plugin_reg_descriptor, i);
+    if (!strcmp(d->name, "r0")) regR0 = d->handle;
+    if (!strcmp(d->name, "r1")) regR1 = d->handle;
+  }
+  g_array_free(regs, TRUE);
+}
+
+static void on_atexit(qemu_plugin_id_t id, void *udata)
+{
+  (void)id;
+  (void)udata;
+  if (out) fclose(out);
+}
+
+QEMU_PLUGIN_EXPORT int qemu_plugin_install(qemu_plugin_id_t id, const qemu_info_t *info, int argc, char **argv)
+{
+  if (info->system_emulation && info->system.smp_vcpus != 1) {
+    fprintf(stderr, "kernel_insns: needs a single vCPU\n");
+    return -1;
+  }
+  for (int i = 0; i < argc; i++) {
+    if (!strncmp(argv[i], "marker=", 7)) {
+      markerAddr = strtoull(argv[i] + 7, NULL, 16) & ~1ull;
+    } else if (!strncmp(argv[i], "out=", 4)) {
+      out = fopen(argv[i] + 4, "w");
+      if (!out) {
+        fprintf(stderr, "kernel_insns: cannot open %s\n", argv[i] + 4);
+        return -1;
+      }
+    } else {
+      fprintf(stderr, "kernel_insns: unknown option %s\n", argv[i]);
+      return -1;
+    }
+  }
+  if (!markerAddr) {
+    fprintf(stderr, "kernel_insns: marker=ADDR of kernel_mark is required\n");
+    return -1;
+  }
+  qemu_plugin_register_vcpu_init_cb(id, on_vcpu_init);
+  qemu_plugin_register_vcpu_tb_trans_cb(id, on_tb_trans);
+  qemu_plugin_register_atexit_cb(id, on_atexit, NULL);
+  return 0;
+}
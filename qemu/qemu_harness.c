@@ -0,0 +1,124 @@
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ns_ambiqsuite_harness.h"
+#include "ns_perf_profile.h"
+#include "ns_pmu_utils.h"
+
+// neuralSPOT harness calls for the QEMU build: stdio goes to the host through
+// newlib's semihosting (rdimon), the cycle clock is SysTick, and the profilers
+// have nothing behind them but that clock.
+
+#ifndef QEMU_SYSCLK_HZ
+#define QEMU_SYSCLK_HZ 32000000u
+#endif
+
+uint32_t SystemCoreClock = QEMU_SYSCLK_HZ;
+ITM_Type host_itm;
+const ns_core_api_t ns_pmu_current_version = { .apiId = 0xCA000A, .version = 1 };
+
+// SysTick, processor clock, no interrupt: wraps are caught by COUNTFLAG on
+// each read, so it must be read at least once per 2^24 ticks
+typedef struct {
+  volatile uint32_t CTRL;
+  volatile uint32_t LOAD;
+  volatile uint32_t VAL;
+  volatile uint32_t CALIB;
+} systick_t;
+#define SYSTICK ((systick_t *)0xE000E010u)
+#define SYSTICK_ENABLE (1u << 0)
+#define SYSTICK_CLKSOURCE (1u << 2)
+#define SYSTICK_COUNTFLAG (1u << 16)
+#define SYSTICK_MAX 0x00FFFFFFu
+
+static DWT_Type dwt;
+static bool tickStarted = false;
+static uint32_t tickWraps = 0;
+
+// Reading CTRL clears COUNTFLAG, so it is read once per call, for the flag
+// only; whether SysTick runs is tracked here instead
+uint64_t host_cycles64(void)
+{
+  if (!tickStarted) {
+    SYSTICK->LOAD = SYSTICK_MAX;
+    SYSTICK->VAL = 0;
+    SYSTICK->CTRL = SYSTICK_CLKSOURCE | SYSTICK_ENABLE;
+    tickStarted = true;
+  }
+  uint32_t val = SYSTICK->VAL;
+  if (SYSTICK->CTRL & SYSTICK_COUNTFLAG) {  // wrapped since the last read; re-read past the wrap
+    tickWraps++;
+    val = SYSTICK->VAL;
+  }
+  return ((uint64_t)tickWraps << 24) | (SYSTICK_MAX - val);
+}
+
+DWT_Type *host_dwt(void)
+{
+  dwt.CYCCNT = (uint32_t)host_cycles64();
+  return &dwt;
+}
+
+void ns_lp_printf(const char *format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  vprintf(format, args);
+  va_end(args);
+}
+
+void ns_delay_us(uint32_t us)
+{
+  uint64_t ticks = (uint64_t)us * (SystemCoreClock / 1000000u);
+  uint32_t t0 = DWT->CYCCNT;
+  while (DWT->CYCCNT - t0 < ticks) {
+  }
+}
+
+void *ns_malloc(size_t size) { return malloc(size); }
+
+void ns_free(void *ptr) { free(ptr); }
+
+// DWT profiler: the SysTick clock only
+void ns_init_perf_profiler(void) {}
+void ns_start_perf_profiler(void) {}
+void ns_stop_perf_profiler(void) {}
+void ns_reset_perf_counters(void) {}
+
+void ns_capture_perf_profiler(ns_perf_counters_t *c)
+{
+  memset(c, 0, sizeof(*c));
+  c->cyccnt = DWT->CYCCNT;
+}
+
+void ns_delta_perf(ns_perf_counters_t *s, ns_perf_counters_t *e, ns_perf_counters_t *d)
+{
+  d->cyccnt = e->cyccnt - s->cyccnt;
+  d->cpicnt = e->cpicnt - s->cpicnt;
+  d->exccnt = e->exccnt - s->exccnt;
+  d->sleepcnt = e->sleepcnt - s->sleepcnt;
+  d->lsucnt = e->lsucnt - s->lsucnt;
+  d->foldcnt = e->foldcnt - s->foldcnt;
+}
+
+// QEMU models no PMU; instruction counts come from the TCG plugin instead
+uint32_t ns_pmu_init(ns_pmu_config_t *cfg)
+{
+  (void)cfg;
+  return NS_STATUS_FAILURE;
+}
+
+uint32_t ns_pmu_get_counters(ns_pmu_config_t *cfg)
+{
+  (void)cfg;
+  return NS_STATUS_FAILURE;
+}
+
+void ns_pmu_reset_counters(void) {}
+
+void ns_delta_pmu(ns_pmu_counters_t *s, ns_pmu_counters_t *e, ns_pmu_counters_t *d)
+{
+  for (int i = 0; i < NS_PMU_MAX_COUNTERS; i++) d->counterValue[i] = e->counterValue[i] - s->counterValue[i];
+}
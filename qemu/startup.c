@@ -0,0 +1,31 @@
+#include <stdint.h>
+
+// Reset for the mps3-an547 image: the vector table sits in ITCM at 0x0, where
+// the core fetches it. newlib's rdimon crt0 (_start) then clears .bss, fetches
+// the command line over semihosting for argv, runs main and exits through
+// SYS_EXIT, so QEMU ends with main's status.
+
+extern uint32_t __stack;
+extern void _start(void) __attribute__((noreturn));
+
+#define CPACR (*(volatile uint32_t *)0xE000ED88u)
+
+__attribute__((noreturn)) void Reset_Handler(void)
+{
+  CPACR |= 0xFu << 20;  // CP10/CP11: FPU and MVE
+  __asm volatile("dsb\n isb" ::: "memory");
+  _start();
+}
+
+// Faults end the run rather than hang QEMU: exit through semihosting
+__attribute__((noreturn)) void Fault_Handler(void)
+{
+  register uint32_t op __asm("r0") = 0x18;       // SYS_EXIT
+  register uint32_t arg __asm("r1") = 0x20024u;  // ADP_Stopped_InternalError
+  for (;;) __asm volatile("bkpt 0xAB" : : "r"(op), "r"(arg) : "memory");
+}
+
+__attribute__((section(".vectors"), used)) static void (*const vectors[16])(void) = {
+    (void (*)(void))&__stack, Reset_Handler, Fault_Handler, Fault_Handler, Fault_Handler, Fault_Handler,
+    Fault_Handler,
+};
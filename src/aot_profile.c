@@ -0,0 +1,204 @@
+#include <stdint.h>
+#include <string.h>
+#include "ns_ambiqsuite_harness.h"
+#include "ns_perf_profile.h"
+#include "ns_pmu_utils.h"
+#include "aot_profile.h"
+
+#define X(name, id) id,
+static const uint16_t kEvents[] = { AOT_PROFILE_PMU_EVENT_LIST };
+#undef X
+#define X(name, id) #name,
+static const char *const kEventNames[] = { AOT_PROFILE_PMU_EVENT_LIST };
+#undef X
+_Static_assert(2 * AOT_PROFILE_PMU_COUNT <= 8, "32-bit PMU events take two hardware counters each");
+
+// The --wrap layer, when it is linked in (test builds). It owns the DWT and,
+// at FULL_PMU, the PMU: the profiler shares its clock and leaves its PMU alone
+// instead of restarting them under it. Weak, so production builds link as is.
+extern void kernel_timing_init(void) __attribute__((weak));
+extern uint64_t kernel_cycles_now(void) __attribute__((weak));
+extern bool kernel_timing_owns_pmu(void) __attribute__((weak));
+extern uint32_t kernel_cycles_to_us(uint64_t cycles) __attribute__((weak));
+
+// One operator runs at a time, so the in-flight captures are shared
+static ns_pmu_config_t pmuCfg;
+static ns_perf_counters_t dwtStart, dwtEnd, dwtDelta;
+static uint64_t cyclesStart;
+static uint32_t pmuStart[AOT_PROFILE_PMU_COUNT];
+
+// Start the DWT once: ns_init_perf_profiler() zeroes CYCCNT
+static void dwt_init(void)
+{
+  if (kernel_timing_init) {
+    kernel_timing_init();
+    return;
+  }
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+  if (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) return;
+#endif
+  ns_init_perf_profiler();
+  ns_start_perf_profiler();
+}
+
+// 64-bit clock of the wrap layer when present, else the raw CYCCNT
+static uint64_t cycles_now(void) { return kernel_cycles_now ? kernel_cycles_now() : DWT->CYCCNT; }
+
+// Cycles -> us at the wrap layer's KERNEL_CPU_HZ when present, else SystemCoreClock
+static uint32_t cycles_to_us(uint64_t cycles)
+{
+  return kernel_cycles_to_us ? kernel_cycles_to_us(cycles) : (uint32_t)(cycles * 1000000u / SystemCoreClock);
+}
+
+static bool pmu_init(void)
+{
+#if AOT_PROFILE_PMU
+  if (kernel_timing_owns_pmu && kernel_timing_owns_pmu()) return false;
+  memset(&pmuCfg, 0, sizeof(pmuCfg));
+  pmuCfg.api = &ns_pmu_current_version;
+  for (int i = 0; i < AOT_PROFILE_PMU_COUNT; i++) {
+    pmuCfg.events[i].enabled = true;
+    pmuCfg.events[i].eventId = kEvents[i];
+    pmuCfg.events[i].counterSize = NS_PMU_EVENT_COUNTER_SIZE_32;
+  }
+  return ns_pmu_init(&pmuCfg) == NS_STATUS_SUCCESS;
+#else
+  return false;
+#endif
+}
+
+static void pmu_read(uint32_t *out)
+{
+  ns_pmu_get_counters(&pmuCfg);
+  for (int i = 0; i < AOT_PROFILE_PMU_COUNT; i++) out[i] = pmuCfg.counter[i].counterValue;
+}
+
+void aot_profile_reset(aot_profile_t *p)
+{
+  p->inferences = 0;
+  p->num_stats = 0;
+  p->running = -1;
+  memset(p->stat, 0, sizeof(p->stat));
+}
+
+void aot_profile_init(aot_profile_t *p, const aot_profile_op_t *ops, uint32_t num_ops)
+{
+  p->ops = ops;
+  p->num_ops = ops ? num_ops : 0;
+  aot_profile_reset(p);
+  dwt_init();
+  p->pmu = pmu_init();
+  if (AOT_PROFILE_PMU && !p->pmu) {
+    ns_lp_printf("[AOT_PROFILE] PMU %s, DWT only\n",
+                 kernel_timing_owns_pmu && kernel_timing_owns_pmu() ? "owned by the kernel wrappers" : "unavailable");
+  }
+}
+
+// stat[] slot of op, added in execution order the first time it runs
+static aot_profile_stat_t *stat_of(aot_profile_t *p, int32_t op)
+{
+  for (uint32_t i = 0; i < p->num_stats; i++) {
+    if (p->stat[i].op == op) return &p->stat[i];
+  }
+  if (p->num_stats == AOT_PROFILE_MAX_OPS) return NULL;
+  aot_profile_stat_t *s = &p->stat[p->num_stats++];
+  s->op = op;
+  s->min_cycles = UINT32_MAX;
+  return s;
+}
+
+void aot_profile_callback(int32_t op, aot_operator_state_e state, int32_t status, void *user_data)
+{
+  aot_profile_t *p = (aot_profile_t *)user_data;
+  if (state == aot_model_state_finished) {
+    // Counters first, bookkeeping after: only the operator is inside the window
+    uint64_t cyclesEnd = cycles_now();
+    ns_capture_perf_profiler(&dwtEnd);
+    uint32_t pmuEnd[AOT_PROFILE_PMU_COUNT];
+    if (p->pmu) pmu_read(pmuEnd);
+    if (p->running < 0 || p->stat[p->running].op != op) return;
+    aot_profile_stat_t *s = &p->stat[p->running];
+    p->running = -1;
+
+    ns_delta_perf(&dwtStart, &dwtEnd, &dwtDelta);
+    // A raw CYCCNT difference is taken modulo 2^32
+    uint64_t span = kernel_cycles_now ? cyclesEnd - cyclesStart : (uint32_t)(cyclesEnd - cyclesStart);
+    uint32_t cycles = span > UINT32_MAX ? UINT32_MAX : (uint32_t)span;
+    s->calls++;
+    s->failures += status != 0;
+    s->cycles += cycles;
+    if (cycles < s->min_cycles) s->min_cycles = cycles;
+    if (cycles > s->max_cycles) s->max_cycles = cycles;
+    s->dwt[0] += dwtDelta.cpicnt;
+    s->dwt[1] += dwtDelta.exccnt;
+    s->dwt[2] += dwtDelta.sleepcnt;
+    s->dwt[3] += dwtDelta.lsucnt;
+    s->dwt[4] += dwtDelta.foldcnt;
+    if (p->pmu) {
+      for (int i = 0; i < AOT_PROFILE_PMU_COUNT; i++) s->pmu[i] += pmuEnd[i] - pmuStart[i];
+    }
+    return;
+  }
+
+  aot_profile_stat_t *s = stat_of(p, op);
+  if (!s) return;
+  if (s == &p->stat[0]) p->inferences++;
+  p->running = (int32_t)(s - p->stat);
+  if (p->pmu) pmu_read(pmuStart);
+  ns_capture_perf_profiler(&dwtStart);
+  cyclesStart = cycles_now();
+}
+
+static const aot_profile_op_t *op_info(const aot_profile_t *p, int32_t op)
+{
+  for (uint32_t i = 0; i < p->num_ops; i++) {
+    if (p->ops[i].op == op) return &p->ops[i];
+  }
+  return NULL;
+}
+
+// num / den with two decimals, for integer-only printf
+static void print_ratio(uint64_t num, uint64_t den)
+{
+  uint64_t h = den ? num * 100u / den : 0;
+  ns_lp_printf(" %6lu.%02lu", (unsigned long)(h / 100u), (unsigned long)(h % 100u));
+}
+
+void aot_profile_print(const aot_profile_t *p, const char *label)
+{
+  uint64_t total = 0, macs = 0;
+  for (uint32_t i = 0; i < p->num_stats; i++) {
+    const aot_profile_stat_t *s = &p->stat[i];
+    const aot_profile_op_t *info = op_info(p, s->op);
+    total += s->calls ? s->cycles / s->calls : 0;
+    macs += info ? info->macs : 0;
+  }
+  ns_lp_printf("[AOT_PROFILE] begin label=%s inferences=%lu ops=%lu cycles=%lu us=%lu macs=%lu\n", label,
+               (unsigned long)p->inferences, (unsigned long)p->num_stats, (unsigned long)total,
+               (unsigned long)cycles_to_us(total), (unsigned long)macs);
+  ns_lp_printf("[AOT_OP] %4s %-17s %-11s %10s %10s %10s %9s %9s %9s %10s", "op", "type", "shape", "cycles", "min",
+               "max", "pct", "macs", "macs/cyc", "instr");
+  for (int e = 0; p->pmu && e < AOT_PROFILE_PMU_COUNT; e++) ns_lp_printf(" %s", kEventNames[e]);
+  ns_lp_printf("\n");
+
+  for (uint32_t i = 0; i < p->num_stats; i++) {
+    const aot_profile_stat_t *s = &p->stat[i];
+    const aot_profile_op_t *info = op_info(p, s->op);
+    uint32_t n = s->calls ? s->calls : 1;
+    uint64_t cycles = s->cycles / n;
+    // DWT estimate, as the wrappers' DWT_instructions
+    uint64_t stalls = s->dwt[0] + s->dwt[1] + s->dwt[2] + s->dwt[3];
+    uint64_t instr = s->cycles + s->dwt[4] > stalls ? (s->cycles + s->dwt[4] - stalls) / n : 0;
+    ns_lp_printf("[AOT_OP] %4ld %-17s %-11s %10lu %10lu %10lu", (long)s->op, info ? info->type : "-",
+                 info ? info->shape : "-", (unsigned long)cycles, (unsigned long)(s->calls ? s->min_cycles : 0),
+                 (unsigned long)s->max_cycles);
+    print_ratio(cycles * 100u, total);
+    ns_lp_printf(" %9lu", (unsigned long)(info ? info->macs : 0));
+    print_ratio(info ? info->macs : 0, cycles);
+    ns_lp_printf(" %10lu", (unsigned long)instr);
+    for (int e = 0; p->pmu && e < AOT_PROFILE_PMU_COUNT; e++) ns_lp_printf(" %lu", (unsigned long)(s->pmu[e] / n));
+    if (s->failures) ns_lp_printf(" failures=%lu", (unsigned long)s->failures);
+    ns_lp_printf("\n");
+  }
+  ns_lp_printf("[AOT_PROFILE] end label=%s\n", label);
+}
@@ -0,0 +1,94 @@
+#ifndef AOT_PROFILE_H
+#define AOT_PROFILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "aot_model.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Per-operator profiler for HeliosAOT models. aot_profile_callback() is an
+// aot_operator_callback: set it as the model context's callback, with an
+// aot_profile_t as user_data, after aot_model_init(), and every operator
+// aot_model_run() executes is measured from its started to its finished
+// event: DWT cycles and counters, and the AOT_PROFILE_PMU_EVENT_LIST events
+// when the PMU initializes. Totals add up over inferences until
+// aot_profile_reset(); aot_profile_print() prints the layer table. Only the
+// neuralSPOT profilers are needed, so it links into production builds as is.
+// With the --wrap layer linked in it shares that layer's DWT and 64-bit
+// clock, and counts no PMU events at FULL_PMU, where the wrappers own the PMU.
+#ifndef AOT_PROFILE_MAX_OPS
+#define AOT_PROFILE_MAX_OPS 32
+#endif
+
+// PMU events per operator, X(name, ARMv8.1-M event id), counted 32 bits wide
+// (two hardware counters each, so at most four). The default matches group 0
+// of KERNEL_PMU_EVENT_LIST. 0 = DWT only.
+#ifndef AOT_PROFILE_PMU
+#define AOT_PROFILE_PMU 1
+#endif
+#ifndef AOT_PROFILE_PMU_EVENT_LIST
+#define AOT_PROFILE_PMU_EVENT_LIST \
+  X(CPU_CYCLES, 0x0011)            \
+  X(INST_RETIRED, 0x0008)          \
+  X(MVE_INST_RETIRED, 0x0200)      \
+  X(MVE_INT_MAC_RETIRED, 0x0228)
+#endif
+
+#define X(name, id) +1
+enum { AOT_PROFILE_PMU_COUNT = 0 AOT_PROFILE_PMU_EVENT_LIST };
+#undef X
+
+// What the model's op ids are, for the table; the callback works without it
+typedef struct {
+  int32_t op;         // id passed to the callback
+  const char *type;   // e.g. "CONV_2D"
+  const char *shape;  // output shape, e.g. "1x25x5x64"
+  uint32_t macs;      // multiply-accumulates per run, 0 if not meaningful
+} aot_profile_op_t;
+
+// Sums over every run of one operator
+typedef struct {
+  int32_t op;
+  uint32_t calls;
+  uint32_t failures;  // runs that returned non-zero
+  uint64_t cycles;
+  uint32_t min_cycles;
+  uint32_t max_cycles;
+  uint64_t dwt[5];                     // cpicnt, exccnt, sleepcnt, lsucnt, foldcnt
+  uint64_t pmu[AOT_PROFILE_PMU_COUNT]; // AOT_PROFILE_PMU_EVENT_LIST order
+} aot_profile_stat_t;
+
+typedef struct {
+  const aot_profile_op_t *ops;  // optional description of the op ids
+  uint32_t num_ops;
+  bool pmu;                     // PMU events are being counted
+  uint32_t inferences;          // runs of the first operator seen
+  uint32_t num_stats;           // operators seen, in execution order
+  int32_t running;              // stat[] slot in flight, -1 between operators
+  aot_profile_stat_t stat[AOT_PROFILE_MAX_OPS];
+} aot_profile_t;
+
+// Clear p, describe the model's operators (ops may be NULL) and start the
+// DWT (and PMU) counters
+void aot_profile_init(aot_profile_t *p, const aot_profile_op_t *ops, uint32_t num_ops);
+
+// Forget the totals, keep the description
+void aot_profile_reset(aot_profile_t *p);
+
+void aot_profile_callback(int32_t op, aot_operator_state_e state, int32_t status, void *user_data);
+
+// Layer table, averaged per inference, tagged with label:
+//   [AOT_PROFILE] begin label=... inferences=N ops=N cycles=N us=N macs=N
+//   [AOT_OP] op type shape cycles min max pct macs macs/cyc instr EVENT...
+//   [AOT_OP] 0 CONV_2D 1x25x5x64 ...        (one row per operator)
+//   [AOT_PROFILE] end
+void aot_profile_print(const aot_profile_t *p, const char *label);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AOT_PROFILE_H
@@ -3,7 +3,10 @@
 #include "arm_nnfunctions.h"
 #include "ns_perf_profile.h"
 #include "ns_pmu_utils.h"
+#include "kernel_timing_wrap.h"
+#include "result_store.h"
 #include <stddef.h> 
+#include <string.h>
 
 void *ns_malloc(size_t size);
 void  ns_free(void *ptr);
@@ -17,28 +20,10 @@ void __wrap_free(void *ptr) {
     ns_free(ptr);
 }
 
-extern ns_timer_config_t timerCfg;
+static inline uint32_t sat32(uint64_t v) { return v > UINT32_MAX ? UINT32_MAX : (uint32_t)v; }
 
-// PMU and DWT counter configurations
-static ns_pmu_config_t pmuCfg;
-static ns_perf_counters_t dwtStart, dwtEnd, dwtDelta;
-static ns_pmu_counters_t pmuStart, pmuEnd, pmuDelta;
-static bool pmu_initialized = false;
 static bool dwt_initialized = false;
 
-static inline uint32_t tic_us(void)
-{
-  ns_timer_clear(&timerCfg);
-  return ns_us_ticker_read(&timerCfg);
-}
-
-static inline uint32_t toc_us(uint32_t t0) { return ns_us_ticker_read(&timerCfg) - t0; }
-
-static inline void log_kernel(const char *name, uint32_t us)
-{
-  ns_lp_printf("[KERNEL][%s] %lu\n", name, (unsigned long)us);
-}
-
 // Initialize DWT profiler if not already done
 static void init_dwt_if_needed(void)
 {
@@ -54,120 +39,1369 @@ static void init_dwt_if_needed(void)
   }
 }
 
+#ifndef HOST_CYCLES64
+// Upper word of the 64-bit cycle clock, bumped when CYCCNT is seen to wrap
+static uint32_t cyclesHigh = 0;
+static uint32_t cyclesLast = 0;
+#endif
+
+uint64_t kernel_cycles_now(void)
+{
+  init_dwt_if_needed();
+#ifdef HOST_CYCLES64
+  // The harness has a 64-bit clock (host build): nothing to extend
+  return HOST_CYCLES64();
+#else
+  uint32_t now = DWT->CYCCNT;
+  if (now < cyclesLast) cyclesHigh++;
+  cyclesLast = now;
+  return ((uint64_t)cyclesHigh << 32) | now;
+#endif
+}
+
+uint32_t kernel_cycles_to_us(uint64_t cycles) { return sat32(cycles * 1000000u / KERNEL_CPU_HZ); }
+
+static char lower(char c) { return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c; }
+
+bool kernel_name_match(const char *p, const char *end, const char *name)
+{
+  const char *star = NULL, *resume = NULL;
+  while (*name) {
+    if (p < end && *p == '*') {
+      star = ++p;
+      resume = name;
+    } else if (p < end && (*p == '?' || lower(*p) == lower(*name))) {
+      p++;
+      name++;
+    } else if (star) {
+      p = star;
+      name = ++resume;
+    } else {
+      return false;
+    }
+  }
+  while (p < end && *p == '*') p++;
+  return p == end;
+}
+
+void kernel_timing_init(void) { init_dwt_if_needed(); }
+
+bool kernel_timing_owns_pmu(void) { return KERNEL_TIMING_LEVEL >= KERNEL_TIMING_FULL_PMU; }
+
+#if KERNEL_MARKERS
+// Seen by the plugin at its first instruction; the asm keeps the arguments live
+__attribute__((noinline)) void kernel_mark(kernel_mark_t op, uint32_t arg)
+{
+  __asm volatile("" : : "r"(op), "r"(arg) : "memory");
+}
+#endif
+
+#if KERNEL_TIMING_LEVEL > KERNEL_TIMING_NONE
+#define X(fn) #fn,
+static const char *const kKernelNames[] = { KERNEL_LIST };
+#undef X
+
+// Runtime levels never exceed the compile-time ceiling, so the code above it is never reached
+#define KERNEL_LEVEL_CLAMP(level) ((level) < KERNEL_TIMING_LEVEL ? (level) : KERNEL_TIMING_LEVEL)
+#define KERNEL_LEVEL_ON(level, l) (KERNEL_TIMING_LEVEL >= (l) && (level) >= (l))
+
+#define X(fn) KERNEL_LEVEL_CLAMP(KERNEL_LEVEL_DEFAULT),
+static uint8_t kernelLevel[KERNEL_COUNT] = { KERNEL_LIST };
+#undef X
+
+// Calls of the kernels at KERNEL_LEVEL_COUNT since the last drain
+static uint32_t kernelCalls[KERNEL_COUNT];
+
+void kernel_timing_set_level(kernel_id_t id, kernel_level_t level)
+{
+  if ((uint32_t)id < KERNEL_COUNT) kernelLevel[id] = (uint8_t)KERNEL_LEVEL_CLAMP(level);
+}
+
+uint32_t kernel_timing_set_level_match(const char *patterns, kernel_level_t level)
+{
+  uint32_t matched = 0;
+  for (uint32_t id = 0; id < KERNEL_COUNT; id++) {
+    for (const char *p = patterns; *p;) {
+      while (*p == ',' || *p == ' ') p++;
+      const char *end = p;
+      while (*end && *end != ',' && *end != ' ') end++;
+      if (end > p && kernel_name_match(p, end, kKernelNames[id])) {
+        kernelLevel[id] = (uint8_t)KERNEL_LEVEL_CLAMP(level);
+        matched++;
+        break;
+      }
+      p = end;
+    }
+  }
+  return matched;
+}
+
+// One [COUNT] line per kernel called at KERNEL_LEVEL_COUNT since the last drain
+static void log_calls(void)
+{
+  for (uint32_t id = 0; id < KERNEL_COUNT; id++) {
+    if (!kernelCalls[id]) continue;
+    ns_lp_printf("[COUNT][%s] calls=%lu\n", kKernelNames[id], (unsigned long)kernelCalls[id]);
+    result_store_append(RESULT_KERNEL, (uint8_t)id, kernelCalls[id], 0, 0);
+    kernelCalls[id] = 0;
+  }
+}
+#else
+void kernel_timing_set_level(kernel_id_t id, kernel_level_t level)
+{
+  (void)id;
+  (void)level;
+}
+
+uint32_t kernel_timing_set_level_match(const char *patterns, kernel_level_t level)
+{
+  (void)patterns;
+  (void)level;
+  return 0;
+}
+
+static inline void log_calls(void) {}
+#endif
+
+#if KERNEL_TIMING_LEVEL >= KERNEL_TIMING_CYCLES
+// PMU configuration, and the deltas of the last capture_end_counters(). The
+// start snapshots belong to the caller: a nested wrapped call runs between
+// its parent's start and end captures.
+static ns_pmu_config_t pmuCfg;
+static ns_perf_counters_t dwtDelta;
+static ns_pmu_counters_t pmuDelta;
+#if KERNEL_TIMING_LEVEL >= KERNEL_TIMING_FULL_PMU
+static bool pmu_initialized = false;
+#else
+// Never initialized: every PMU path folds away
+#define pmu_initialized false
+#endif
+static bool pmu_configured = false;
+
+#if KERNEL_HELPERS && !KERNEL_TRACE_RING
+#define X(fn) #fn,
+static const char *const kHelperNames[] = { KERNEL_HELPER_LIST };
+#undef X
+#endif
+
+// PMU event catalogue, programmed KERNEL_PMU_GROUP_SIZE events at a time by pmu_select_group()
+#define X(name, id) id,
+static const uint16_t kPmuEvents[] = { KERNEL_PMU_EVENT_LIST };
+#undef X
+#if !KERNEL_TRACE_RING
+#define X(name, id) #name,
+static const char *const kPmuEventNames[] = { KERNEL_PMU_EVENT_LIST };
+#undef X
+#endif
+#define KERNEL_PMU_EVENT_COUNT (sizeof(kPmuEvents) / sizeof(kPmuEvents[0]))
+#define KERNEL_PMU_GROUP_COUNT ((KERNEL_PMU_EVENT_COUNT + KERNEL_PMU_GROUP_SIZE - 1) / KERNEL_PMU_GROUP_SIZE)
+_Static_assert(
+    2 * KERNEL_PMU_GROUP_SIZE <= KERNEL_TRACE_PMU_COUNT, "32-bit PMU events take two hardware counters each");
+
+// Nesting of measured wrapper calls; cache preparation and re-runs apply to outermost calls only
+static uint32_t kernelDepth = 0;
+
+static uint32_t pmuGroup = 0;
+static bool pmuMultiplex = KERNEL_PMU_MULTIPLEX;
+
+// Minimum per-counter cost of an empty wrapped call, from kernel_timing_calibrate()
+static uint32_t dwtBaseline[KERNEL_TRACE_DWT_COUNT];
+static uint32_t pmuBaseline[KERNEL_PMU_EVENT_COUNT];
+static uint32_t calibSamples = 0;
+
+static inline uint32_t sub_floor(uint32_t v, uint32_t base) { return v > base ? v - base : 0; }
+
+// DWT delta in kernel_trace_record_t.dwt[] order
+static inline void dwt_fields(const ns_perf_counters_t *d, uint32_t *out)
+{
+  out[0] = d->cyccnt;
+  out[1] = d->cpicnt;
+  out[2] = d->exccnt;
+  out[3] = d->sleepcnt;
+  out[4] = d->lsucnt;
+  out[5] = d->foldcnt;
+}
+
+#if KERNEL_TRACE_RING
+_Static_assert((KERNEL_TRACE_DEPTH & (KERNEL_TRACE_DEPTH - 1)) == 0, "KERNEL_TRACE_DEPTH must be a power of two");
+_Static_assert(sizeof(kernel_trace_record_t) == 64, "trace record layout changed; update tools/trace_decode.py");
+_Static_assert(sizeof(kernel_shape_record_t) == sizeof(kernel_trace_record_t), "shape records share the trace ring");
+_Static_assert(KERNEL_COUNT + KERNEL_HELPER_COUNT <= UINT8_MAX, "kernel ids are 8 bits in trace records");
+
+// Preallocated record ring, filled by the wrappers and emptied by kernel_trace_drain()
+static kernel_trace_record_t traceRing[KERNEL_TRACE_DEPTH];
+static uint32_t traceHead = 0;
+static uint32_t traceCount = 0;
+static uint32_t traceDropped = 0;
+
+// Reserve the next slot, or count a drop when the ring is full so earlier records survive
+static inline kernel_trace_record_t *trace_alloc(void)
+{
+  if (traceCount == KERNEL_TRACE_DEPTH) {
+    traceDropped++;
+    return NULL;
+  }
+  return &traceRing[(traceHead + traceCount++) & (KERNEL_TRACE_DEPTH - 1)];
+}
+#endif
+
+
+#if !KERNEL_TRACE_RING
+// Printf-path tag for the KERNEL_TRACE_COLD/KERNEL_TRACE_WARM record flags
+static inline const char *cache_tag(uint8_t flags)
+{
+  return (flags & KERNEL_TRACE_COLD) ? "cold" : (flags & KERNEL_TRACE_WARM) ? "warm" : NULL;
+}
+#endif
+
+// Time-only record: elapsed cycles from the free-running clock, no counters
+static inline void log_kernel(kernel_id_t id, uint64_t cycles, uint8_t flags)
+{
+#if KERNEL_TRACE_RING
+  kernel_trace_record_t *rec = trace_alloc();
+  if (rec) {
+    rec->kernel_id = (uint8_t)id;
+    rec->depth = (uint8_t)kernelDepth;
+    rec->flags = flags | KERNEL_TRACE_CYCLES;
+    rec->status = 0;
+    rec->time_us = kernel_cycles_to_us(cycles);
+    rec->dwt[0] = sat32(cycles);
+  }
+#else
+  ns_lp_printf(
+      "[KERNEL][%s] %lu cycles=%lu", kKernelNames[id], (unsigned long)kernel_cycles_to_us(cycles),
+      (unsigned long)sat32(cycles));
+  if (kernelDepth) ns_lp_printf(" depth=%lu", (unsigned long)kernelDepth);
+  if (cache_tag(flags)) ns_lp_printf(" cache=%s", cache_tag(flags));
+  ns_lp_printf("\n");
+#endif
+}
+
+
+// Program catalogue group g into pmuCfg.events[]; every event is counted 32 bits wide
+static void pmu_select_group(uint32_t g)
+{
+  for (uint32_t i = 0; i < KERNEL_TRACE_PMU_COUNT; i++) {
+    uint32_t e = g * KERNEL_PMU_GROUP_SIZE + i;
+    pmuCfg.events[i].enabled = i < KERNEL_PMU_GROUP_SIZE && e < KERNEL_PMU_EVENT_COUNT;
+    pmuCfg.events[i].eventId = pmuCfg.events[i].enabled ? kPmuEvents[e] : 0;
+    pmuCfg.events[i].counterSize = NS_PMU_EVENT_COUNTER_SIZE_32;
+  }
+#if KERNEL_TIMING_LEVEL >= KERNEL_TIMING_FULL_PMU
+  pmu_initialized = ns_pmu_init(&pmuCfg) == NS_STATUS_SUCCESS;
+#endif
+  pmuGroup = g;
+}
+
 // Initialize PMU counters if not already done
 static void init_pmu_if_needed(void)
 {
-  if (!pmu_initialized) {
-    // Initialize PMU with specific performance events
+  if (KERNEL_TIMING_LEVEL >= KERNEL_TIMING_FULL_PMU && !pmu_configured) {
+    pmu_configured = true;
     pmuCfg.api = &ns_pmu_current_version;
-    
-    // Configure PMU events as requested
-    pmuCfg.events[0].enabled = true;
-    pmuCfg.events[0].eventId = 0x0200; // ARM_PMU_MVE_INST_RETIRED
-    pmuCfg.events[0].counterSize = NS_PMU_EVENT_COUNTER_SIZE_32;
-    
-    pmuCfg.events[1].enabled = true;
-    pmuCfg.events[1].eventId = 0x0228; // ARM_PMU_MVE_INT_MAC_RETIRED
-    pmuCfg.events[1].counterSize = NS_PMU_EVENT_COUNTER_SIZE_32;
-    
-    pmuCfg.events[2].enabled = true;
-    pmuCfg.events[2].eventId = 0x0008; // ARM_PMU_INST_RETIRED
-    pmuCfg.events[2].counterSize = NS_PMU_EVENT_COUNTER_SIZE_32;
-    
-    pmuCfg.events[3].enabled = true;
-    pmuCfg.events[3].eventId = 0x001D; // ARM_PMU_BUS_CYCLES
-    pmuCfg.events[3].counterSize = NS_PMU_EVENT_COUNTER_SIZE_32;
-    
-    pmuCfg.events[4].enabled = true;
-    pmuCfg.events[4].eventId = 0x0011; // ARM_PMU_CPU_CYCLES
-    pmuCfg.events[4].counterSize = NS_PMU_EVENT_COUNTER_SIZE_32;
-    
-    pmuCfg.events[5].enabled = true;
-    pmuCfg.events[5].eventId = 0x0003; // ARM_PMU_L1D_CACHE_REFILL
-    pmuCfg.events[5].counterSize = NS_PMU_EVENT_COUNTER_SIZE_32;
-    
-    pmuCfg.events[6].enabled = true;
-    pmuCfg.events[6].eventId = 0x0001; // ARM_PMU_L1I_CACHE_REFILL
-    pmuCfg.events[6].counterSize = NS_PMU_EVENT_COUNTER_SIZE_32;
-    
-    // // Initialize PMU
-    // if (ns_pmu_init(&pmuCfg) == NS_STATUS_SUCCESS) {
-    //   pmu_initialized = true;
-    //   ns_lp_printf("[PMU] Initialized with 7 counters: MVE_INST_RETIRED, MVE_INT_MAC_RETIRED, INST_RETIRED, BUS_CYCLES, CPU_CYCLES, L1D_CACHE_REFILL, L1I_CACHE_REFILL\n");
-    // } else {
-    //   ns_lp_printf("[PMU] Failed to initialize PMU counters\n");
-    // }
+    pmu_select_group(0);
+    if (pmu_initialized) {
+      ns_lp_printf(
+          "[PMU] Initialized: %d catalogue events in %d groups of %d\n", (int)KERNEL_PMU_EVENT_COUNT,
+          (int)KERNEL_PMU_GROUP_COUNT, KERNEL_PMU_GROUP_SIZE);
+    } else {
+      ns_lp_printf("[PMU] Failed to initialize PMU counters\n");
+    }
   }
 }
 
-// Capture PMU and DWT counters before kernel call
-static void capture_start_counters(void)
+// Capture PMU (when pmu is set) and DWT counters before kernel call into
+// dwt0/pmu0. The PMU is read outside the DWT window, so the DWT baseline holds
+// with or without it.
+static void capture_start_counters(bool pmu, ns_perf_counters_t *dwt0, ns_pmu_counters_t *pmu0)
 {
   init_dwt_if_needed();
   init_pmu_if_needed();
   
-  // Capture DWT counters
-  ns_capture_perf_profiler(&dwtStart);
-  
-  
   // Capture PMU counters if initialized
-  if (pmu_initialized) {
+  if (pmu && pmu_initialized) {
     ns_pmu_get_counters(&pmuCfg);
-    for (int i = 0; i < 8; i++) {
-      if (pmuCfg.events[i].enabled) {
-        pmuStart.counterValue[i] = pmuCfg.counter[i].counterValue;
-      }
+    for (int i = 0; i < NS_PMU_MAX_COUNTERS; i++) {
+      pmu0->counterValue[i] = pmuCfg.events[i].enabled ? pmuCfg.counter[i].counterValue : 0;
     }
   }
+
+  // Capture DWT counters
+  ns_capture_perf_profiler(dwt0);
 }
 
-// Capture PMU and DWT counters after kernel call and log them
-static void capture_end_counters_and_log(const char *name, uint32_t timing_us, arm_cmsis_nn_status status)
+// Capture DWT and PMU (when pmu is set) counters after kernel call and take
+// the deltas from the start snapshot dwt0/pmu0
+static void capture_end_counters(bool pmu, ns_perf_counters_t *dwt0, ns_pmu_counters_t *pmu0)
 {
+  ns_perf_counters_t dwtEnd;
+  ns_pmu_counters_t pmuEnd;
+
   // Capture DWT counters
   ns_capture_perf_profiler(&dwtEnd);
-  
-  
+
   // Calculate DWT delta
-  ns_delta_perf(&dwtStart, &dwtEnd, &dwtDelta);
+  ns_delta_perf(dwt0, &dwtEnd, &dwtDelta);
   
   // Capture PMU counters if initialized
-  if (pmu_initialized) {
+  if (pmu && pmu_initialized) {
     ns_pmu_get_counters(&pmuCfg);
-    for (int i = 0; i < 8; i++) {
-      if (pmuCfg.events[i].enabled) {
-        pmuEnd.counterValue[i] = pmuCfg.counter[i].counterValue;
-      }
+    for (int i = 0; i < NS_PMU_MAX_COUNTERS; i++) {
+      pmuEnd.counterValue[i] = pmuCfg.events[i].enabled ? pmuCfg.counter[i].counterValue : 0;
     }
     
     // Calculate PMU delta
-    ns_delta_pmu(&pmuStart, &pmuEnd, &pmuDelta);
+    ns_delta_pmu(pmu0, &pmuEnd, &pmuDelta);
   }
-  
-  // Log all counters in one line: kernel_name, time, status, counter1, counter2, etc.
+}
+
+#if !KERNEL_TRACE_RING
+static inline uint32_t dwt_instructions(const ns_perf_counters_t *d)
+{
+  return d->cyccnt - d->cpicnt - d->exccnt - d->sleepcnt - d->lsucnt + d->foldcnt;
+}
+
+// Enabled slots of the programmed group, by catalogue name
+static void print_pmu(void)
+{
+  for (int i = 0; i < KERNEL_PMU_GROUP_SIZE; i++) {
+    if (!pmuCfg.events[i].enabled) continue;
+    uint32_t e = pmuGroup * KERNEL_PMU_GROUP_SIZE + i;
+    ns_lp_printf("%s=%lu, ", kPmuEventNames[e], (unsigned long)pmuDelta.counterValue[i]);
+    if (calibSamples) {
+      ns_lp_printf(
+          "%s_corr=%lu, ", kPmuEventNames[e], (unsigned long)sub_floor(pmuDelta.counterValue[i], pmuBaseline[e]));
+    }
+  }
+}
+
+static void print_dwt(const char *suffix, const ns_perf_counters_t *d)
+{
+  ns_lp_printf(
+      "DWT_cycles%s=%lu, DWT_instructions%s=%lu, DWT_cpi%s=%lu, DWT_exceptions%s=%lu, DWT_sleep%s=%lu, "
+      "DWT_lsu%s=%lu, DWT_fold%s=%lu, ",
+      suffix, (unsigned long)d->cyccnt, suffix, (unsigned long)dwt_instructions(d), suffix, (unsigned long)d->cpicnt,
+      suffix, (unsigned long)d->exccnt, suffix, (unsigned long)d->sleepcnt, suffix, (unsigned long)d->lsucnt, suffix,
+      (unsigned long)d->foldcnt);
+}
+#endif
+
+// Log the deltas from the last capture_start_counters()/capture_end_counters() pair; PMU deltas when pmu is set
+static void log_counters(kernel_id_t id, uint32_t timing_us, arm_cmsis_nn_status status, uint8_t flags, bool pmu)
+{
+  pmu = pmu && pmu_initialized;
+#if KERNEL_TRACE_RING
+  // Only a handful of stores here; formatting happens in kernel_trace_drain()
+  kernel_trace_record_t *rec = trace_alloc();
+  if (rec) {
+    rec->kernel_id = (uint8_t)id;
+    rec->depth = (uint8_t)kernelDepth;
+    rec->flags = flags | KERNEL_TRACE_HAS_DWT | (pmu ? KERNEL_TRACE_HAS_PMU : 0);
+    rec->status = (int8_t)status;
+    rec->time_us = timing_us;
+    dwt_fields(&dwtDelta, rec->dwt);
+    if (pmu) {
+      for (int i = 0; i < KERNEL_TRACE_PMU_COUNT; i++) {
+        rec->pmu[i] = pmuDelta.counterValue[i];
+      }
+    }
+  }
+#else
+  // Log all counters in one line: kernel_name, status, time, raw counters, then overhead-corrected counters
   const char* status_str = (status == ARM_CMSIS_NN_SUCCESS) ? "SUCCESS" : "FAILURE";
-  ns_lp_printf("%s, Status=%s(%d), ", name, status_str, (int)status);
+  ns_lp_printf("%s, Status=%s(%d), Time_us=%lu, ", kKernelNames[id], status_str, (int)status, (unsigned long)timing_us);
+  if (kernelDepth) ns_lp_printf("Depth=%lu, ", (unsigned long)kernelDepth);
+  if (cache_tag(flags)) ns_lp_printf("Cache=%s, ", cache_tag(flags));
   
   // DWT counters
-  ns_lp_printf("DWT_cycles=%lu, DWT_instructions=%lu, DWT_cpi=%lu, DWT_exceptions=%lu, DWT_sleep=%lu, DWT_lsu=%lu, DWT_fold=%lu, ", 
-               (unsigned long)(dwtDelta.cyccnt - dwtDelta.cpicnt - dwtDelta.exccnt - dwtDelta.sleepcnt - dwtDelta.lsucnt + dwtDelta.foldcnt),
-               (unsigned long)dwtDelta.cpicnt, (unsigned long)dwtDelta.exccnt, 
-               (unsigned long)dwtDelta.sleepcnt, (unsigned long)dwtDelta.lsucnt, (unsigned long)dwtDelta.foldcnt);
+  print_dwt("", &dwtDelta);
+  if (calibSamples) {
+    ns_perf_counters_t corr = {
+        .cyccnt = sub_floor(dwtDelta.cyccnt, dwtBaseline[0]),
+        .cpicnt = sub_floor(dwtDelta.cpicnt, dwtBaseline[1]),
+        .exccnt = sub_floor(dwtDelta.exccnt, dwtBaseline[2]),
+        .sleepcnt = sub_floor(dwtDelta.sleepcnt, dwtBaseline[3]),
+        .lsucnt = sub_floor(dwtDelta.lsucnt, dwtBaseline[4]),
+        .foldcnt = sub_floor(dwtDelta.foldcnt, dwtBaseline[5]),
+    };
+    print_dwt("_corr", &corr);
+  }
   
   // PMU counters
+  if (pmu) print_pmu();
+  
+  ns_lp_printf("\n");
+#endif
+}
+
+// Log the PMU deltas of a KERNEL_PMU_MULTIPLEX re-run with event group g programmed
+static void log_pmu_group(kernel_id_t id, uint32_t g)
+{
+#if KERNEL_TRACE_RING
+  kernel_trace_record_t *rec = trace_alloc();
+  if (rec) {
+    rec->kernel_id = (uint8_t)id;
+    rec->depth = (uint8_t)kernelDepth;
+    rec->flags = KERNEL_TRACE_PMU_GROUP | KERNEL_TRACE_HAS_DWT | KERNEL_TRACE_HAS_PMU;
+    rec->status = 0;
+    rec->time_us = g;
+    dwt_fields(&dwtDelta, rec->dwt);
+    for (int i = 0; i < KERNEL_TRACE_PMU_COUNT; i++) {
+      rec->pmu[i] = pmuDelta.counterValue[i];
+    }
+  }
+#else
+  ns_lp_printf("[PMU][%s] group=%lu ", kKernelNames[id], (unsigned long)g);
+  print_pmu();
+  ns_lp_printf("\n");
+#endif
+}
+
+// Operand shapes: the wrapper fills a kernel_shape_record_t before the call, outside the measured window
+typedef enum { SHAPE_CONV, SHAPE_DEPTHWISE, SHAPE_TRANSPOSE_CONV } shape_conv_kind_t;
+
+static inline uint16_t sat16(int32_t v) { return v < 0 ? 0 : v > UINT16_MAX ? UINT16_MAX : (uint16_t)v; }
+static inline uint8_t sat8(int32_t v) { return v < 0 ? 0 : v > UINT8_MAX ? UINT8_MAX : (uint8_t)v; }
+static inline uint64_t dims_count(const cmsis_nn_dims *d) { return (uint64_t)d->n * d->h * d->w * d->c; }
+
+static void shape_init(kernel_shape_record_t *s, uint32_t elem_bytes, const cmsis_nn_dims *in, const cmsis_nn_dims *out)
+{
+  memset(s, 0, sizeof(*s));
+  s->peak_macs = elem_bytes == 1 ? KERNEL_MVE_PEAK_MACS_S8 : KERNEL_MVE_PEAK_MACS_S16;
+  if (in) {
+    s->input[0] = (uint32_t)in->n;
+    s->input[1] = (uint32_t)in->h;
+    s->input[2] = (uint32_t)in->w;
+    s->input[3] = (uint32_t)in->c;
+  }
+  if (out) {
+    s->output[0] = (uint32_t)out->n;
+    s->output[1] = (uint32_t)out->h;
+    s->output[2] = (uint32_t)out->w;
+    s->output[3] = (uint32_t)out->c;
+  }
+}
+
+static void shape_filter(kernel_shape_record_t *s, const cmsis_nn_dims *filter)
+{
+  s->filter[0] = sat16(filter->n);
+  s->filter[1] = sat16(filter->h);
+  s->filter[2] = sat16(filter->w);
+  s->filter[3] = sat16(filter->c);
+}
+
+static void shape_tiles(
+    kernel_shape_record_t *s, const cmsis_nn_tile *stride, const cmsis_nn_tile *padding, const cmsis_nn_tile *dilation)
+{
+  s->stride[0] = sat8(stride->h);
+  s->stride[1] = sat8(stride->w);
+  s->padding[0] = sat8(padding->h);
+  s->padding[1] = sat8(padding->w);
+  s->dilation[0] = dilation ? sat8(dilation->h) : 1;
+  s->dilation[1] = dilation ? sat8(dilation->w) : 1;
+}
+
+// Convolutions; weight_bits is 4 for the packed s4 kernels
+static void shape_conv(
+    kernel_shape_record_t *s, shape_conv_kind_t kind, const cmsis_nn_dims *in, const cmsis_nn_dims *filter,
+    const cmsis_nn_dims *out, const cmsis_nn_tile *stride, const cmsis_nn_tile *padding, const cmsis_nn_tile *dilation,
+    uint32_t elem_bytes, uint32_t weight_bits, uint32_t bias_bytes)
+{
+  uint64_t taps = (uint64_t)filter->h * filter->w;
+  uint64_t macs = kind == SHAPE_CONV        ? dims_count(out) * taps * in->c
+                  : kind == SHAPE_DEPTHWISE ? dims_count(out) * taps
+                                            : dims_count(in) * taps * out->c;
+  shape_init(s, elem_bytes, in, out);
+  shape_filter(s, filter);
+  shape_tiles(s, stride, padding, dilation);
+  s->macs = sat32(macs);
+  s->bytes = sat32(
+      (dims_count(in) + dims_count(out)) * elem_bytes + dims_count(filter) * weight_bits / 8 +
+      (uint64_t)out->c * bias_bytes);
+}
+
+// Fully connected: filter n is the accumulation depth, output c the number of outputs
+static void shape_fc(
+    kernel_shape_record_t *s, const cmsis_nn_dims *in, const cmsis_nn_dims *filter, const cmsis_nn_dims *out,
+    uint32_t elem_bytes, uint32_t weight_bits, uint32_t bias_bytes)
+{
+  uint64_t weights = (uint64_t)filter->n * out->c;
+  shape_init(s, elem_bytes, in, out);
+  shape_filter(s, filter);
+  s->macs = sat32((uint64_t)in->n * weights);
+  s->bytes = sat32(
+      (dims_count(in) + dims_count(out)) * elem_bytes + weights * weight_bits / 8 + (uint64_t)out->c * bias_bytes);
+}
+
+// Batch matmul; the rhs operand is recorded in the filter slot
+static void shape_bmm(
+    kernel_shape_record_t *s, const cmsis_nn_dims *lhs, const cmsis_nn_dims *rhs, const cmsis_nn_dims *out,
+    uint32_t elem_bytes)
+{
+  shape_init(s, elem_bytes, lhs, out);
+  shape_filter(s, rhs);
+  s->macs = sat32(dims_count(out) * lhs->c);
+  s->bytes = sat32((dims_count(lhs) + dims_count(rhs) + dims_count(out)) * elem_bytes);
+}
+
+static void shape_pool(
+    kernel_shape_record_t *s, const cmsis_nn_pool_params *params, const cmsis_nn_dims *in,
+    const cmsis_nn_dims *filter, const cmsis_nn_dims *out, uint32_t elem_bytes)
+{
+  shape_init(s, elem_bytes, in, out);
+  shape_filter(s, filter);
+  shape_tiles(s, &params->stride, &params->padding, NULL);
+  s->bytes = sat32((dims_count(in) + dims_count(out)) * elem_bytes);
+}
+
+// Two-operand broadcast kernels; the second operand is recorded in the filter slot
+static void shape_binary(
+    kernel_shape_record_t *s, const cmsis_nn_dims *in1, const cmsis_nn_dims *in2, const cmsis_nn_dims *out,
+    uint32_t elem_bytes, uint32_t macs_per_output)
+{
+  shape_init(s, elem_bytes, in1, out);
+  shape_filter(s, in2);
+  s->macs = sat32(dims_count(out) * macs_per_output);
+  s->bytes = sat32((dims_count(in1) + dims_count(in2) + dims_count(out)) * elem_bytes);
+}
+
+// Single-operand kernels with tensor dims (reductions, transpose)
+static void shape_unary(
+    kernel_shape_record_t *s, const cmsis_nn_dims *in, const cmsis_nn_dims *out, uint32_t elem_bytes)
+{
+  shape_init(s, elem_bytes, in, out);
+  s->bytes = sat32((dims_count(in) + dims_count(out)) * elem_bytes);
+}
+
+// Flat vectors of count elements read from each of inputs operands
+static void shape_flat(
+    kernel_shape_record_t *s, int32_t count, uint32_t inputs, uint32_t in_bytes, uint32_t out_bytes,
+    uint32_t macs_per_output)
+{
+  cmsis_nn_dims d = {1, 1, 1, count};
+  shape_init(s, in_bytes == 1 ? 1 : 2, &d, &d);
+  s->macs = sat32((uint64_t)count * macs_per_output);
+  s->bytes = sat32((uint64_t)count * (inputs * in_bytes + out_bytes));
+}
+
+static void shape_pad(
+    kernel_shape_record_t *s, const cmsis_nn_dims *in, const cmsis_nn_dims *pre, const cmsis_nn_dims *post,
+    uint32_t elem_bytes)
+{
+  cmsis_nn_dims out = {
+      in->n + pre->n + post->n, in->h + pre->h + post->h, in->w + pre->w + post->w, in->c + pre->c + post->c};
+  shape_unary(s, in, &out, elem_bytes);
+}
+
+// Strided slice only reads the elements it writes
+static void shape_slice(kernel_shape_record_t *s, const cmsis_nn_dims *in, const cmsis_nn_dims *out)
+{
+  shape_init(s, 1, in, out);
+  s->bytes = sat32(2 * dims_count(out));
+}
+
+// Per-row weight sums precomputed for the conv/fc kernels: rows x cols accumulations, int32 out
+static void shape_weight_sum(kernel_shape_record_t *s, int32_t rows, int32_t cols, uint32_t weight_bits)
+{
+  cmsis_nn_dims w = {rows, 1, 1, cols};
+  shape_init(s, 1, NULL, NULL);
+  shape_filter(s, &w);
+  s->output[0] = s->output[1] = s->output[2] = 1;
+  s->output[3] = (uint32_t)rows;
+  s->macs = sat32((uint64_t)rows * cols);
+  s->bytes = sat32((uint64_t)rows * cols * weight_bits / 8 + (uint64_t)rows * sizeof(int32_t));
+}
+
+static void log_shape(kernel_id_t id, const kernel_shape_record_t *shape)
+{
+  if (!shape) return;
+#if KERNEL_TRACE_RING
+  kernel_trace_record_t *rec = trace_alloc();
+  if (rec) {
+    kernel_shape_record_t tagged = *shape;
+    tagged.kernel_id = (uint8_t)id;
+    tagged.depth = (uint8_t)kernelDepth;
+    tagged.flags = KERNEL_TRACE_SHAPE;
+    memcpy(rec, &tagged, sizeof(tagged));
+  }
+#else
+  ns_lp_printf(
+      "[SHAPE][%s] in=%lux%lux%lux%lu filter=%ux%ux%ux%u out=%lux%lux%lux%lu stride=%ux%u pad=%ux%u dilation=%ux%u "
+      "macs=%lu bytes=%lu peak=%u\n",
+      kKernelNames[id], (unsigned long)shape->input[0], (unsigned long)shape->input[1],
+      (unsigned long)shape->input[2], (unsigned long)shape->input[3], shape->filter[0], shape->filter[1],
+      shape->filter[2], shape->filter[3], (unsigned long)shape->output[0], (unsigned long)shape->output[1],
+      (unsigned long)shape->output[2], (unsigned long)shape->output[3], shape->stride[0], shape->stride[1],
+      shape->padding[0], shape->padding[1], shape->dilation[0], shape->dilation[1], (unsigned long)shape->macs,
+      (unsigned long)shape->bytes, shape->peak_macs);
+#endif
+}
+
+// Set while a kernel runs outside any measurement (warm-up, re-runs): nested wrappers call straight through
+static bool passThrough = false;
+
+// Per-call records (ring or printf) on; off leaves only the KERNEL_STATS aggregates
+static bool recordsOn = KERNEL_RECORDS;
+
+void kernel_timing_set_records(bool enable) { recordsOn = enable; }
+
+// Shadow call stack, indexed by kernelDepth. A nested wrapped call charges
+// everything it ran inside its parent's measured window, other than the deltas
+// it logged itself, to the parent's frame; the parent subtracts that before
+// logging. Logged counters are then inclusive of nested kernels' work only,
+// and exclusive values are the parent's minus its children's.
+typedef struct {
+  uint64_t enterCycles;
+  ns_perf_counters_t enterDwt;
+  ns_pmu_counters_t enterPmu;
+  uint64_t loggedCycles;    // elapsed cycles this call logged
+  uint8_t loggedLevel;      // kernel_level_t it logged at: dwtDelta (DWT), pmuDelta (PMU) hold what it logged
+  uint64_t hiddenCycles;    // nested instrumentation inside this call's window
+  uint32_t hiddenDwt[KERNEL_TRACE_DWT_COUNT];
+  uint32_t hiddenPmu[KERNEL_TRACE_PMU_COUNT];
+#if KERNEL_HELPERS
+  struct {
+    uint32_t calls, cycles, min, max;
+  } helpers[KERNEL_HELPER_COUNT];   // helper calls made directly under this call
+#endif
+} kernel_frame_t;
+
+static kernel_frame_t frameStack[KERNEL_STACK_DEPTH];
+
+static inline kernel_frame_t *frame_top(void)
+{
+  return kernelDepth < KERNEL_STACK_DEPTH ? &frameStack[kernelDepth] : NULL;
+}
+
+// Snapshot DWT and the enabled PMU slots into caller-owned storage
+static void capture_counters(ns_perf_counters_t *dwt, ns_pmu_counters_t *pmu)
+{
+  ns_capture_perf_profiler(dwt);
   if (pmu_initialized) {
-    if (pmuCfg.events[0].enabled) ns_lp_printf("MVE_INST_RETIRED=%lu, ", (unsigned long)pmuDelta.counterValue[0]);
-    if (pmuCfg.events[1].enabled) ns_lp_printf("MVE_INT_MAC_RETIRED=%lu, ", (unsigned long)pmuDelta.counterValue[1]);
-    if (pmuCfg.events[2].enabled) ns_lp_printf("INST_RETIRED=%lu, ", (unsigned long)pmuDelta.counterValue[2]);
-    if (pmuCfg.events[3].enabled) ns_lp_printf("BUS_CYCLES=%lu, ", (unsigned long)pmuDelta.counterValue[3]);
-    if (pmuCfg.events[4].enabled) ns_lp_printf("CPU_CYCLES=%lu, ", (unsigned long)pmuDelta.counterValue[4]);
-    if (pmuCfg.events[5].enabled) ns_lp_printf("L1D_CACHE_REFILL=%lu, ", (unsigned long)pmuDelta.counterValue[5]);
-    if (pmuCfg.events[6].enabled) ns_lp_printf("L1I_CACHE_REFILL=%lu, ", (unsigned long)pmuDelta.counterValue[6]);
+    ns_pmu_get_counters(&pmuCfg);
+    for (int i = 0; i < KERNEL_TRACE_PMU_COUNT; i++) {
+      pmu->counterValue[i] = pmuCfg.events[i].enabled ? pmuCfg.counter[i].counterValue : 0;
+    }
+  }
+}
+
+static void frame_clear_hidden(kernel_frame_t *f)
+{
+  f->hiddenCycles = 0;
+  memset(f->hiddenDwt, 0, sizeof(f->hiddenDwt));
+  memset(f->hiddenPmu, 0, sizeof(f->hiddenPmu));
+}
+
+// Wrapper entry: open a frame; nested calls also note where their span starts in the parent's window
+static void frame_enter(void)
+{
+  kernel_frame_t *f = frame_top();
+  if (!f) return;
+  f->loggedCycles = 0;
+  f->loggedLevel = KERNEL_LEVEL_TIME;
+  frame_clear_hidden(f);
+#if KERNEL_HELPERS
+  memset(f->helpers, 0, sizeof(f->helpers));
+#endif
+  if (kernelDepth) {
+    if (KERNEL_TIMING_LEVEL >= KERNEL_TIMING_DWT) capture_counters(&f->enterDwt, &f->enterPmu);
+    f->enterCycles = kernel_cycles_now();
+  }
+}
+
+// After the timed call: remove nested instrumentation from the deltas about to be logged at level
+static uint64_t frame_settle(uint64_t cycles, uint8_t level)
+{
+  kernel_frame_t *f = frame_top();
+  if (!f) return cycles;
+  cycles = cycles > f->hiddenCycles ? cycles - f->hiddenCycles : 0;
+  if (KERNEL_LEVEL_ON(level, KERNEL_LEVEL_DWT)) {
+    dwtDelta.cyccnt = sub_floor(dwtDelta.cyccnt, f->hiddenDwt[0]);
+    dwtDelta.cpicnt = sub_floor(dwtDelta.cpicnt, f->hiddenDwt[1]);
+    dwtDelta.exccnt = sub_floor(dwtDelta.exccnt, f->hiddenDwt[2]);
+    dwtDelta.sleepcnt = sub_floor(dwtDelta.sleepcnt, f->hiddenDwt[3]);
+    dwtDelta.lsucnt = sub_floor(dwtDelta.lsucnt, f->hiddenDwt[4]);
+    dwtDelta.foldcnt = sub_floor(dwtDelta.foldcnt, f->hiddenDwt[5]);
+  }
+  for (int i = 0; KERNEL_LEVEL_ON(level, KERNEL_LEVEL_PMU) && pmu_initialized && i < KERNEL_TRACE_PMU_COUNT; i++) {
+    pmuDelta.counterValue[i] = sub_floor(pmuDelta.counterValue[i], f->hiddenPmu[i]);
+  }
+  f->loggedCycles = cycles;
+  f->loggedLevel = level;
+  // Consumed; the warm call of KERNEL_CACHE_COLD_WARM collects its own
+  frame_clear_hidden(f);
+  return cycles;
+}
+
+// Wrapper exit: charge this call's span, minus what it logged, to the parent frame.
+// Counters below the call's level were not logged, so they stay in the parent.
+static void frame_exit(void)
+{
+  kernel_frame_t *f = frame_top();
+  if (!f || !kernelDepth) return;
+  uint64_t span = kernel_cycles_now() - f->enterCycles;
+  kernel_frame_t *parent = f - 1;
+  parent->hiddenCycles += span > f->loggedCycles ? span - f->loggedCycles : 0;
+  // Below DWT only cycles are ever logged
+  if (KERNEL_TIMING_LEVEL < KERNEL_TIMING_DWT) return;
+
+  ns_perf_counters_t exitDwt, spanDwt;
+  ns_pmu_counters_t exitPmu, spanPmu;
+  capture_counters(&exitDwt, &exitPmu);
+  ns_delta_perf(&f->enterDwt, &exitDwt, &spanDwt);
+  if (!KERNEL_LEVEL_ON(f->loggedLevel, KERNEL_LEVEL_DWT)) {
+    parent->hiddenDwt[0] += sub_floor(spanDwt.cyccnt, sat32(f->loggedCycles));
+    return;
+  }
+  uint32_t span6[KERNEL_TRACE_DWT_COUNT], logged6[KERNEL_TRACE_DWT_COUNT];
+  dwt_fields(&spanDwt, span6);
+  dwt_fields(&dwtDelta, logged6);
+  for (int i = 0; i < KERNEL_TRACE_DWT_COUNT; i++) {
+    parent->hiddenDwt[i] += sub_floor(span6[i], logged6[i]);
+  }
+  if (KERNEL_LEVEL_ON(f->loggedLevel, KERNEL_LEVEL_PMU) && pmu_initialized) {
+    ns_delta_pmu(&f->enterPmu, &exitPmu, &spanPmu);
+    for (int i = 0; i < KERNEL_TRACE_PMU_COUNT; i++) {
+      parent->hiddenPmu[i] += sub_floor(spanPmu.counterValue[i], pmuDelta.counterValue[i]);
+    }
+  }
+}
+
+#if KERNEL_HELPERS
+// Instrumentation cost of one helper call outside its measured window, from kernel_timing_calibrate()
+static uint32_t helperOverhead = 0;
+
+// Frame of the wrapped call a helper runs under, or NULL when the helper is not measured
+static inline kernel_frame_t *helper_frame(void)
+{
+  if (passThrough || !kernelDepth || kernelDepth > KERNEL_STACK_DEPTH) return NULL;
+  return &frameStack[kernelDepth - 1];
+}
+
+// Aggregate one helper call; like a nested call's, its instrumentation is hidden from the parent
+static inline void helper_add(kernel_frame_t *f, kernel_helper_t h, uint32_t cycles)
+{
+  if (!f->helpers[h].calls || cycles < f->helpers[h].min) f->helpers[h].min = cycles;
+  if (cycles > f->helpers[h].max) f->helpers[h].max = cycles;
+  f->helpers[h].calls++;
+  f->helpers[h].cycles += cycles;
+  f->hiddenCycles += helperOverhead;
+  f->hiddenDwt[0] += helperOverhead;
+}
+
+// Helper wrapper body for helper h: two CYCCNT reads and an add, no record of its own
+#define HELPER_MEASURE(h, ret, call)                                         \
+  do {                                                                       \
+    kernel_frame_t *f_ = helper_frame();                                     \
+    if (!f_) {                                                               \
+      ret = (call);                                                          \
+      break;                                                                 \
+    }                                                                        \
+    uint32_t t0_ = DWT->CYCCNT;                                              \
+    ret = (call);                                                            \
+    helper_add(f_, (h), DWT->CYCCNT - t0_);                                  \
+  } while (0)
+
+// Log and reset the helper aggregates of the call about to be logged. Like
+// nested calls they precede their parent and sit one level below it.
+static void log_helpers(kernel_id_t parent)
+{
+  kernel_frame_t *f = frame_top();
+  if (!f) return;
+  for (int h = 0; recordsOn && h < KERNEL_HELPER_COUNT; h++) {
+    if (!f->helpers[h].calls) continue;
+#if KERNEL_TRACE_RING
+    (void)parent;
+    kernel_trace_record_t *rec = trace_alloc();
+    if (rec) {
+      rec->kernel_id = (uint8_t)(KERNEL_COUNT + h);
+      rec->depth = (uint8_t)(kernelDepth + 1);
+      rec->flags = KERNEL_TRACE_CYCLES;
+      rec->status = 0;
+      rec->time_us = f->helpers[h].calls;
+      rec->dwt[0] = f->helpers[h].cycles;
+      rec->dwt[1] = f->helpers[h].min;
+      rec->dwt[2] = f->helpers[h].max;
+    }
+#else
+    ns_lp_printf(
+        "[HELPER][%s] parent=%s calls=%lu cycles=%lu min=%lu max=%lu\n", kHelperNames[h], kKernelNames[parent],
+        (unsigned long)f->helpers[h].calls, (unsigned long)f->helpers[h].cycles, (unsigned long)f->helpers[h].min,
+        (unsigned long)f->helpers[h].max);
+#endif
+  }
+  memset(f->helpers, 0, sizeof(f->helpers));
+}
+#else
+static inline void log_helpers(kernel_id_t parent) { (void)parent; }
+#endif
+
+static kernel_cache_mode_t cacheMode = (kernel_cache_mode_t)KERNEL_CACHE_MODE;
+
+void kernel_timing_set_cache_mode(kernel_cache_mode_t mode) { cacheMode = mode; }
+
+// Clean and invalidate both L1 caches so the next call starts cold
+static void cache_flush(void)
+{
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+  SCB_CleanInvalidateDCache();
+#endif
+#if defined(__ICACHE_PRESENT) && (__ICACHE_PRESENT == 1U)
+  SCB_InvalidateICache();
+#endif
+}
+
+// Kernels whose output depends on state left behind by the previous call
+static const bool kKernelStateful[KERNEL_COUNT] = {
+    [KERNEL_ID(arm_lstm_unidirectional_s16)] = true,
+    [KERNEL_ID(arm_lstm_unidirectional_s8)] = true,
+    [KERNEL_ID(arm_svdf_s8)] = true,
+    [KERNEL_ID(arm_svdf_state_s16_s8)] = true,
+};
+
+// Prepare the caches for the logged call and return its KERNEL_TRACE_COLD/WARM
+// flag. The WARM warm-up run and the warm call of COLD_WARM are issued by
+// KERNEL_MEASURE; a call that must run once (a stateful kernel would advance
+// its state twice, an in-place one read its own output) is measured as is.
+static uint8_t cache_begin(bool once)
+{
+  if (kernelDepth || cacheMode == KERNEL_CACHE_AS_IS) return 0;
+  if (once && cacheMode != KERNEL_CACHE_COLD) return 0;
+  if (cacheMode == KERNEL_CACHE_WARM) return KERNEL_TRACE_WARM;
+  cache_flush();
+  return KERNEL_TRACE_COLD;
+}
+
+void kernel_timing_set_pmu_multiplex(bool enable) { pmuMultiplex = enable; }
+
+// Event groups to collect by re-running the call just logged (0 = none); a
+// call that must run once only has group 0
+static inline uint32_t pmu_multiplex_groups(bool once)
+{
+  return (pmuMultiplex && !kernelDepth && pmu_initialized && !once) ? KERNEL_PMU_GROUP_COUNT : 0;
+}
+
+// Repeat mode state; kernel_timing_set_repeat() documents the policy
+static uint32_t repeatMax = KERNEL_REPEAT_MAX < KERNEL_REPEAT_CAP ? KERNEL_REPEAT_MAX : KERNEL_REPEAT_CAP;
+static uint32_t repeatCiPermille = KERNEL_REPEAT_CI;
+static uint32_t repeatSamples[KERNEL_REPEAT_CAP];
+static uint32_t repeatCount;
+static kernel_id_t repeatKernel;
+static float repeatMean, repeatM2;
+
+void kernel_timing_set_repeat(uint32_t max_repeats, uint32_t ci_permille)
+{
+  repeatMax = max_repeats < KERNEL_REPEAT_CAP ? max_repeats : KERNEL_REPEAT_CAP;
+  repeatCiPermille = ci_permille;
+}
+
+// Start re-running the call just logged; only outermost calls are repeated so the
+// re-runs never land inside another kernel's measured window
+static bool repeat_begin(kernel_id_t id, bool once)
+{
+  // Re-runs are timed with the DWT counters
+  if (KERNEL_TIMING_LEVEL < KERNEL_TIMING_DWT || !repeatMax || kernelDepth || once) return false;
+  repeatKernel = id;
+  repeatCount = 0;
+  repeatMean = 0.0f;
+  repeatM2 = 0.0f;
+  passThrough = true;
+  return true;
+}
+
+// Nearest-rank percentile of the sorted samples
+static inline uint32_t repeat_percentile(uint32_t pct)
+{
+  uint32_t rank = (pct * repeatCount + 99) / 100;
+  return repeatSamples[rank ? rank - 1 : 0];
+}
+
+static void repeat_log(void)
+{
+  // Insertion sort; at most KERNEL_REPEAT_CAP samples and outside any measured window
+  for (uint32_t i = 1; i < repeatCount; i++) {
+    uint32_t v = repeatSamples[i];
+    uint32_t j = i;
+    for (; j && repeatSamples[j - 1] > v; j--) repeatSamples[j] = repeatSamples[j - 1];
+    repeatSamples[j] = v;
+  }
+  uint32_t stats[KERNEL_TRACE_DWT_COUNT] = {
+      repeatSamples[0],
+      repeat_percentile(50),
+      repeat_percentile(90),
+      repeat_percentile(99),
+      (uint32_t)(repeatMean + 0.5f),
+      (uint32_t)(__builtin_sqrtf(repeatCount > 1 ? repeatM2 / (float)(repeatCount - 1) : 0.0f) + 0.5f),
+  };
+#if KERNEL_TRACE_RING
+  kernel_trace_record_t *rec = trace_alloc();
+  if (rec) {
+    rec->kernel_id = (uint8_t)repeatKernel;
+    rec->depth = 0;
+    rec->flags = KERNEL_TRACE_STATS;
+    rec->status = 0;
+    rec->time_us = repeatCount;
+    for (int i = 0; i < KERNEL_TRACE_DWT_COUNT; i++) rec->dwt[i] = stats[i];
+    for (int i = 0; i < KERNEL_TRACE_PMU_COUNT; i++) rec->pmu[i] = 0;
+  }
+#else
+  ns_lp_printf(
+      "[REPEAT][%s] n=%lu min=%lu median=%lu p90=%lu p99=%lu mean=%lu stddev=%lu\n", kKernelNames[repeatKernel],
+      (unsigned long)repeatCount, (unsigned long)stats[0], (unsigned long)stats[1], (unsigned long)stats[2],
+      (unsigned long)stats[3], (unsigned long)stats[4], (unsigned long)stats[5]);
+#endif
+}
+
+// Record the re-run just captured; returns false once the CI target or the cap is reached
+static bool repeat_next(void)
+{
+  uint32_t cycles = sub_floor(dwtDelta.cyccnt, dwtBaseline[0]);
+  repeatSamples[repeatCount++] = cycles;
+
+  // Welford running mean/variance
+  float delta = (float)cycles - repeatMean;
+  repeatMean += delta / (float)repeatCount;
+  repeatM2 += delta * ((float)cycles - repeatMean);
+
+  bool done = repeatCount >= repeatMax;
+  if (!done && repeatCount >= KERNEL_REPEAT_MIN) {
+    // 1.96^2 * var / n <= (ci * mean)^2, i.e. the 95% CI half-width is within target
+    float var = repeatM2 / (float)(repeatCount - 1);
+    float halfWidth = (float)repeatCiPermille * repeatMean / 1000.0f;
+    done = 3.8416f * var / (float)repeatCount <= halfWidth * halfWidth;
+  }
+  if (done) {
+    repeat_log();
+    passThrough = false;
+  }
+  return !done;
+}
+
+#if KERNEL_STATS
+// Running aggregates per kernel over every logged call since the last reset.
+// hist[b] counts calls of [2^(b + KERNEL_STATS_MIN_LOG2), 2^(b + 1 + KERNEL_STATS_MIN_LOG2))
+// cycles; the first and last buckets are open-ended.
+typedef struct {
+  uint32_t count, min, max;
+  uint64_t sum, sumsq;
+  uint32_t hist[KERNEL_STATS_BUCKETS];
+} kernel_stats_t;
+
+static kernel_stats_t kernelStats[KERNEL_COUNT];
+
+static inline void stats_add(kernel_id_t id, uint32_t cycles)
+{
+  kernel_stats_t *st = &kernelStats[id];
+  if (!st->count++ || cycles < st->min) st->min = cycles;
+  if (cycles > st->max) st->max = cycles;
+  st->sum += cycles;
+  uint64_t sq = (uint64_t)cycles * cycles;
+  st->sumsq = st->sumsq + sq < st->sumsq ? UINT64_MAX : st->sumsq + sq;  // saturate
+  int32_t b = cycles ? 31 - __builtin_clz(cycles) - KERNEL_STATS_MIN_LOG2 : 0;
+  st->hist[b < 0 ? 0 : b >= KERNEL_STATS_BUCKETS ? KERNEL_STATS_BUCKETS - 1 : b]++;
+}
+
+// Decimal text of v; ns_lp_printf has no portable 64-bit conversion
+static const char *u64_dec(char *buf, uint64_t v)
+{
+  char *p = buf + 20;
+  *p = '\0';
+  do {
+    *--p = (char)('0' + v % 10);
+    v /= 10;
+  } while (v);
+  return p;
+}
+
+void kernel_stats_dump(const char *label)
+{
+  char sum[21], sumsq[21];
+  ns_lp_printf(
+      "[STATS] begin label=%s buckets=%d log2=%d\n", label, KERNEL_STATS_BUCKETS, KERNEL_STATS_MIN_LOG2);
+  for (uint32_t id = 0; id < KERNEL_COUNT; id++) {
+    const kernel_stats_t *st = &kernelStats[id];
+    if (!st->count) continue;
+    ns_lp_printf(
+        "[STATS][%s] n=%lu sum=%s min=%lu max=%lu sumsq=%s hist=", kKernelNames[id], (unsigned long)st->count,
+        u64_dec(sum, st->sum), (unsigned long)st->min, (unsigned long)st->max, u64_dec(sumsq, st->sumsq));
+    // Trailing empty buckets are left out
+    int last = KERNEL_STATS_BUCKETS - 1;
+    while (last > 0 && !st->hist[last]) last--;
+    for (int b = 0; b <= last; b++) ns_lp_printf("%s%lu", b ? "," : "", (unsigned long)st->hist[b]);
+    ns_lp_printf("\n");
+  }
+  ns_lp_printf("[STATS] end\n");
+}
+
+void kernel_stats_reset(void) { memset(kernelStats, 0, sizeof(kernelStats)); }
+
+bool kernel_stats_get(kernel_id_t id, uint32_t *count, uint64_t *sum)
+{
+  const kernel_stats_t *st = (uint32_t)id < KERNEL_COUNT ? &kernelStats[id] : NULL;
+  *count = st ? st->count : 0;
+  *sum = st ? st->sum : 0;
+  return *count != 0;
+}
+#else
+static inline void stats_add(kernel_id_t id, uint32_t cycles)
+{
+  (void)id;
+  (void)cycles;
+}
+
+void kernel_stats_dump(const char *label) { (void)label; }
+void kernel_stats_reset(void) {}
+
+bool kernel_stats_get(kernel_id_t id, uint32_t *count, uint64_t *sum)
+{
+  (void)id;
+  *count = 0;
+  *sum = 0;
+  return false;
+}
+#endif
+
+// Cycles of the outermost logged calls since kernel_timing_take_cycles()
+static uint64_t kernelCycles = 0;
+
+uint64_t kernel_timing_take_cycles(void)
+{
+  uint64_t cycles = kernelCycles;
+  kernelCycles = 0;
+  return cycles;
+}
+
+#if RESULT_STORE
+// Per-kernel totals of the current test, appended to the result store at each drain
+typedef struct {
+  uint32_t calls, max;
+  uint64_t cycles;
+} kernel_result_t;
+
+static kernel_result_t kernelResults[KERNEL_COUNT];
+
+static inline void result_add(kernel_id_t id, uint32_t cycles)
+{
+  kernel_result_t *r = &kernelResults[id];
+  r->calls++;
+  r->cycles += cycles;
+  if (cycles > r->max) r->max = cycles;
+}
+
+static void store_results(void)
+{
+  for (uint32_t id = 0; id < KERNEL_COUNT; id++) {
+    kernel_result_t *r = &kernelResults[id];
+    if (!r->calls) continue;
+    result_store_append(RESULT_KERNEL, (uint8_t)id, r->calls, sat32(r->cycles), r->max);
+    memset(r, 0, sizeof(*r));
+  }
+}
+#else
+static inline void result_add(kernel_id_t id, uint32_t cycles)
+{
+  (void)id;
+  (void)cycles;
+}
+
+static inline void store_results(void) {}
+#endif
+
+// One timed call of the real kernel into rc at level (TIME, DWT or PMU), followed
+// by its shape record when shape is not NULL. The start snapshots are locals, so
+// wrapped calls nested in call leave this call's deltas alone.
+#define KERNEL_CALL(fn, shape, rc, call, flags, level)                       \
+  do {                                                                       \
+    uint64_t t0_ = kernel_cycles_now();                                      \
+    kernelDepth++;                                                           \
+    if (KERNEL_LEVEL_ON(level, KERNEL_LEVEL_DWT)) {                          \
+      bool pmu_ = KERNEL_LEVEL_ON(level, KERNEL_LEVEL_PMU);                  \
+      ns_perf_counters_t dwt0_;                                              \
+      ns_pmu_counters_t pmu0_;                                               \
+      capture_start_counters(pmu_, &dwt0_, &pmu0_);                          \
+      KERNEL_MARK(KERNEL_MARK_START, KERNEL_ID(fn));                         \
+      rc = (call);                                                           \
+      KERNEL_MARK(KERNEL_MARK_END, KERNEL_ID(fn));                           \
+      capture_end_counters(pmu_, &dwt0_, &pmu0_);                            \
+    } else {                                                                 \
+      KERNEL_MARK(KERNEL_MARK_START, KERNEL_ID(fn));                         \
+      rc = (call);                                                           \
+      KERNEL_MARK(KERNEL_MARK_END, KERNEL_ID(fn));                           \
+    }                                                                        \
+    uint64_t cycles_ = kernel_cycles_now() - t0_;                            \
+    kernelDepth--;                                                           \
+    cycles_ = frame_settle(cycles_, (level));                                \
+    uint32_t stat_ = KERNEL_LEVEL_ON(level, KERNEL_LEVEL_DWT)                \
+                         ? sub_floor(dwtDelta.cyccnt, dwtBaseline[0])        \
+                         : sat32(cycles_);                                   \
+    stats_add(KERNEL_ID(fn), stat_);                                         \
+    result_add(KERNEL_ID(fn), stat_);                                        \
+    if (!kernelDepth) kernelCycles += stat_;                                 \
+    log_helpers(KERNEL_ID(fn));                                              \
+    if (!recordsOn) break;                                                   \
+    if (KERNEL_LEVEL_ON(level, KERNEL_LEVEL_DWT))                            \
+      log_counters(KERNEL_ID(fn), kernel_cycles_to_us(cycles_), rc, (flags), \
+                   KERNEL_LEVEL_ON(level, KERNEL_LEVEL_PMU));                \
+    else                                                                     \
+      log_kernel(KERNEL_ID(fn), cycles_, (flags));                           \
+    log_shape(KERNEL_ID(fn), (shape));                                       \
+  } while (0)
+
+// Run the real kernel with measurement off
+#define KERNEL_CALL_UNMEASURED(call)                                         \
+  do {                                                                       \
+    passThrough = true;                                                      \
+    (void)(call);                                                            \
+    passThrough = false;                                                     \
+  } while (0)
+
+// Wrapper body. A kernel at KERNEL_LEVEL_OFF, or any call made while
+// measurement is off, costs one branch; one at KERNEL_LEVEL_COUNT a second
+// branch and an increment. Otherwise: shadow stack frame, cache
+// preparation, the logged call, the warm call of KERNEL_CACHE_COLD_WARM, one
+// re-run per PMU event group not yet counted (PMU level only), then the
+// re-runs of repeat mode. shape is a kernel_shape_record_t * or NULL;
+// inplace is true when the call's output aliases an input, which like a
+// stateful kernel rules out every extra run.
+#define KERNEL_MEASURE(fn, shape, inplace, rc, call)                         \
+  do {                                                                       \
+    uint8_t level_ = kernelLevel[KERNEL_ID(fn)];                             \
+    if ((level_ == KERNEL_LEVEL_OFF) | passThrough) {                        \
+      rc = (call);                                                           \
+      break;                                                                 \
+    }                                                                        \
+    if (level_ == KERNEL_LEVEL_COUNT) {                                      \
+      kernelCalls[KERNEL_ID(fn)]++;                                          \
+      rc = (call);                                                           \
+      break;                                                                 \
+    }                                                                        \
+    KERNEL_MARK(KERNEL_MARK_PAUSE, KERNEL_ID(fn));                           \
+    frame_enter();                                                           \
+    bool once_ = kKernelStateful[KERNEL_ID(fn)] || (inplace);                \
+    uint8_t cache_ = cache_begin(once_);                                     \
+    if (cache_ == KERNEL_TRACE_WARM) KERNEL_CALL_UNMEASURED(call);           \
+    KERNEL_CALL(fn, (shape), rc, call, cache_, level_);                      \
+    if (cache_ == KERNEL_TRACE_COLD && cacheMode == KERNEL_CACHE_COLD_WARM)  \
+      KERNEL_CALL(fn, NULL, rc, call, KERNEL_TRACE_WARM, level_);            \
+    ns_perf_counters_t dwt0_;                                                \
+    ns_pmu_counters_t pmu0_;                                                 \
+    uint32_t groups_ =                                                       \
+        level_ == KERNEL_LEVEL_PMU ? pmu_multiplex_groups(once_) : 0;        \
+    for (uint32_t g_ = 1; g_ < groups_; g_++) {                              \
+      if (cacheMode == KERNEL_CACHE_COLD) cache_flush();                     \
+      pmu_select_group(g_);                                                  \
+      passThrough = true;                                                    \
+      capture_start_counters(true, &dwt0_, &pmu0_);                          \
+      (void)(call);                                                          \
+      capture_end_counters(true, &dwt0_, &pmu0_);                            \
+      passThrough = false;                                                   \
+      log_pmu_group(KERNEL_ID(fn), g_);                                      \
+    }                                                                        \
+    if (pmuGroup) pmu_select_group(0);                                       \
+    if (repeat_begin(KERNEL_ID(fn), once_)) {                                \
+      do {                                                                   \
+        if (cacheMode == KERNEL_CACHE_COLD) cache_flush();                   \
+        capture_start_counters(false, &dwt0_, &pmu0_);                       \
+        (void)(call);                                                        \
+        capture_end_counters(false, &dwt0_, &pmu0_);                         \
+      } while (repeat_next());                                               \
+    }                                                                        \
+    frame_exit();                                                            \
+    KERNEL_MARK(KERNEL_MARK_RESUME, KERNEL_ID(fn));                          \
+  } while (0)
+
+// Stand-in for __real_* during calibration; noinline so the call itself is measured
+static __attribute__((noinline)) arm_cmsis_nn_status calib_empty_kernel(void) { return ARM_CMSIS_NN_SUCCESS; }
+
+void kernel_timing_calibrate(uint32_t iterations)
+{
+  arm_cmsis_nn_status (*volatile kernel)(void) = calib_empty_kernel;
+
+  if (iterations == 0) iterations = KERNEL_CALIB_ITERATIONS;
+
+  init_dwt_if_needed();
+  init_pmu_if_needed();
+
+#if KERNEL_TIMING_LEVEL >= KERNEL_TIMING_DWT
+  // Same sequence a wrapper runs, minus the log; keep the per-counter minimum
+  for (int i = 0; i < KERNEL_TRACE_DWT_COUNT; i++) dwtBaseline[i] = UINT32_MAX;
+  for (uint32_t e = 0; e < KERNEL_PMU_EVENT_COUNT; e++) pmuBaseline[e] = pmu_initialized ? UINT32_MAX : 0;
+
+  // One pass per event group so every catalogue event gets its own baseline
+  uint32_t groups = pmu_initialized ? KERNEL_PMU_GROUP_COUNT : 1;
+  for (uint32_t g = 0; g < groups; g++) {
+    if (pmu_initialized) pmu_select_group(g);
+    for (uint32_t n = 0; n < iterations; n++) {
+      uint32_t dwt[KERNEL_TRACE_DWT_COUNT];
+      ns_perf_counters_t dwt0;
+      ns_pmu_counters_t pmu0;
+      uint64_t t0 = kernel_cycles_now();
+      capture_start_counters(true, &dwt0, &pmu0);
+      (void)kernel();
+      capture_end_counters(true, &dwt0, &pmu0);
+      (void)(kernel_cycles_now() - t0);
+      dwt_fields(&dwtDelta, dwt);
+      for (int i = 0; i < KERNEL_TRACE_DWT_COUNT; i++) {
+        if (dwt[i] < dwtBaseline[i]) dwtBaseline[i] = dwt[i];
+      }
+      for (int i = 0; pmu_initialized && i < KERNEL_PMU_GROUP_SIZE; i++) {
+        uint32_t e = g * KERNEL_PMU_GROUP_SIZE + i;
+        if (e < KERNEL_PMU_EVENT_COUNT && pmuDelta.counterValue[i] < pmuBaseline[e]) {
+          pmuBaseline[e] = pmuDelta.counterValue[i];
+        }
+      }
+    }
+  }
+  if (pmuGroup) pmu_select_group(0);
+#endif
+  calibSamples = iterations;
+
+#if KERNEL_HELPERS
+  // Helper cost outside its measured window: the span of a measured empty
+  // call, minus what the helper measured, minus the span of two bare reads
+  uint32_t span = UINT32_MAX, inner = UINT32_MAX, reads = UINT32_MAX;
+  kernelDepth = 1;
+  for (uint32_t n = 0; n < iterations; n++) {
+    arm_cmsis_nn_status rc;
+    memset(frameStack[0].helpers, 0, sizeof(frameStack[0].helpers));
+    uint32_t a = DWT->CYCCNT;
+    uint32_t b = DWT->CYCCNT;
+    if (b - a < reads) reads = b - a;
+    a = DWT->CYCCNT;
+    HELPER_MEASURE((kernel_helper_t)0, rc, kernel());
+    b = DWT->CYCCNT;
+    (void)rc;
+    if (b - a < span) span = b - a;
+    if (frameStack[0].helpers[0].cycles < inner) inner = frameStack[0].helpers[0].cycles;
+  }
+  kernelDepth = 0;
+  memset(frameStack[0].helpers, 0, sizeof(frameStack[0].helpers));
+  frame_clear_hidden(&frameStack[0]);
+  helperOverhead = sub_floor(span, inner + reads);
+#endif
+
+  // One line per boot; tools/trace_decode.py and tools/perf_db.py apply it to [TRACE] records
+  ns_lp_printf(
+      "[CALIB] n=%lu cyccnt=%lu cpicnt=%lu exccnt=%lu sleepcnt=%lu lsucnt=%lu foldcnt=%lu pmu=",
+      (unsigned long)calibSamples, (unsigned long)dwtBaseline[0], (unsigned long)dwtBaseline[1],
+      (unsigned long)dwtBaseline[2], (unsigned long)dwtBaseline[3], (unsigned long)dwtBaseline[4],
+      (unsigned long)dwtBaseline[5]);
+  // Per catalogue event, in KERNEL_PMU_EVENT_LIST order
+  for (uint32_t e = 0; e < KERNEL_PMU_EVENT_COUNT; e++) {
+    ns_lp_printf("%s%lu", e ? "," : "", (unsigned long)pmuBaseline[e]);
+  }
+#if KERNEL_HELPERS
+  ns_lp_printf(" helper=%lu", (unsigned long)helperOverhead);
+#endif
+  ns_lp_printf(" events=");
+  for (uint32_t e = 0; e < KERNEL_PMU_EVENT_COUNT; e++) {
+    ns_lp_printf("%s%x", e ? "," : "", (unsigned)kPmuEvents[e]);
+  }
+  ns_lp_printf("\n");
+}
+
+void kernel_trace_drain(const char *test_name)
+{
+  log_calls();
+  store_results();
+#if KERNEL_TRACE_RING
+  static const char hex[] = "0123456789abcdef";
+  char line[2 * sizeof(kernel_trace_record_t) + 1];
+
+  // Header names the test and the PMU event id behind each pmu[] slot
+  ns_lp_printf(
+      "[TRACE] begin v=%d test=%s records=%lu dropped=%lu kernels=%d helpers=%d pmu=", KERNEL_TRACE_VERSION,
+      test_name, (unsigned long)traceCount, (unsigned long)traceDropped, (int)KERNEL_COUNT,
+      (int)(KERNEL_HELPERS ? KERNEL_HELPER_COUNT : 0));
+  for (int i = 0; i < KERNEL_TRACE_PMU_COUNT; i++) {
+    ns_lp_printf(
+        "%s%lx", i ? "," : "", (unsigned long)(pmuCfg.events[i].enabled ? pmuCfg.events[i].eventId : 0));
+  }
+  // Catalogue behind KERNEL_TRACE_PMU_GROUP records: group g is events[g*groupsize...]
+  ns_lp_printf(" groupsize=%d events=", KERNEL_PMU_GROUP_SIZE);
+  for (uint32_t e = 0; e < KERNEL_PMU_EVENT_COUNT; e++) {
+    ns_lp_printf("%s%x", e ? "," : "", (unsigned)kPmuEvents[e]);
   }
-  
   ns_lp_printf("\n");
+
+  while (traceCount) {
+    const uint8_t *bytes = (const uint8_t *)&traceRing[traceHead];
+    for (size_t i = 0; i < sizeof(kernel_trace_record_t); i++) {
+      line[2 * i] = hex[bytes[i] >> 4];
+      line[2 * i + 1] = hex[bytes[i] & 0xF];
+    }
+    line[sizeof(line) - 1] = '\0';
+    ns_lp_printf("[TRACE] %s\n", line);
+    traceHead = (traceHead + 1) & (KERNEL_TRACE_DEPTH - 1);
+    traceCount--;
+  }
+  traceDropped = 0;
+  ns_lp_printf("[TRACE] end\n");
+#else
+  (void)test_name;
+#endif
+}
+#else // KERNEL_TIMING_LEVEL < KERNEL_TIMING_CYCLES
+// Nothing is measured per call: the controls have nothing to act on
+void kernel_timing_calibrate(uint32_t iterations) { (void)iterations; }
+void kernel_timing_set_repeat(uint32_t max_repeats, uint32_t ci_permille)
+{
+  (void)max_repeats;
+  (void)ci_permille;
+}
+void kernel_timing_set_cache_mode(kernel_cache_mode_t mode) { (void)mode; }
+void kernel_timing_set_pmu_multiplex(bool enable) { (void)enable; }
+void kernel_timing_set_records(bool enable) { (void)enable; }
+uint64_t kernel_timing_take_cycles(void) { return 0; }
+void kernel_stats_dump(const char *label) { (void)label; }
+void kernel_stats_reset(void) {}
+
+bool kernel_stats_get(kernel_id_t id, uint32_t *count, uint64_t *sum)
+{
+  (void)id;
+  *count = 0;
+  *sum = 0;
+  return false;
 }
 
+void kernel_trace_drain(const char *test_name)
+{
+  (void)test_name;
+  log_calls();
+}
+
+#if KERNEL_TIMING_LEVEL == KERNEL_TIMING_COUNT_ONLY
+// Shapes are not logged; the builders compile to nothing
+#define KERNEL_SHAPE_NONE(s, ...) ((void)(s))
+#define shape_binary KERNEL_SHAPE_NONE
+#define shape_bmm KERNEL_SHAPE_NONE
+#define shape_conv KERNEL_SHAPE_NONE
+#define shape_fc KERNEL_SHAPE_NONE
+#define shape_flat KERNEL_SHAPE_NONE
+#define shape_pad KERNEL_SHAPE_NONE
+#define shape_pool KERNEL_SHAPE_NONE
+#define shape_slice KERNEL_SHAPE_NONE
+#define shape_unary KERNEL_SHAPE_NONE
+#define shape_weight_sum KERNEL_SHAPE_NONE
+
+// Wrapper body: count the call unless the kernel is off
+#define KERNEL_MEASURE(fn, shape, inplace, rc, call)                         \
+  do {                                                                       \
+    kernel_id_t id_ = KERNEL_ID(fn);                                         \
+    (void)(shape);                                                           \
+    (void)(inplace);                                                         \
+    if (kernelLevel[id_] != KERNEL_LEVEL_OFF) kernelCalls[id_]++;            \
+    rc = (call);                                                             \
+    (void)rc;                                                                \
+  } while (0)
+#endif
+#endif // KERNEL_TIMING_LEVEL >= KERNEL_TIMING_CYCLES
+
+#if KERNEL_TIMING_LEVEL > KERNEL_TIMING_NONE
+
+// Wrappers generated by tools/gen_wrappers.py from the CMSIS-NN prototypes; edit the generator, not
+// this region. Each times one KERNEL_MEASURE of the real kernel.
+// BEGIN GENERATED kernel wrappers
 // arm_add_s16
 arm_cmsis_nn_status __real_arm_add_s16(
     const int16_t *input1_data, const cmsis_nn_dims *input1_dims, const int16_t *input2_data,
@@ -184,13 +1418,15 @@ arm_cmsis_nn_status __wrap_arm_add_s16(
     const int32_t left_shift, int16_t *output_data, const cmsis_nn_dims *output_dims, const int32_t out_offset,
     const int32_t out_mult, const int32_t out_shift, const int32_t out_activation_min, const int32_t out_activation_max)
 {
-  uint32_t t0 = tic_us();
-  capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_add_s16(
-      input1_data, input1_dims, input2_data, input2_dims, input1_offset, input1_mult, input1_shift, input2_offset,
-      input2_mult, input2_shift, left_shift, output_data, output_dims, out_offset, out_mult, out_shift,
-      out_activation_min, out_activation_max);
-  capture_end_counters_and_log("arm_add_s16", toc_us(t0), rc);
+  kernel_shape_record_t shape;
+  shape_binary(&shape, input1_dims, input2_dims, output_dims, sizeof(int16_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_add_s16, &shape, output_data == input1_data || output_data == input2_data, rc,
+      __real_arm_add_s16(
+          input1_data, input1_dims, input2_data, input2_dims, input1_offset, input1_mult, input1_shift, input2_offset,
+          input2_mult, input2_shift, left_shift, output_data, output_dims, out_offset, out_mult, out_shift,
+          out_activation_min, out_activation_max));
   return rc;
 }
 
@@ -210,14 +1446,15 @@ arm_cmsis_nn_status __wrap_arm_add_s8(
     const int32_t left_shift, int8_t *output_data, const cmsis_nn_dims *output_dims, const int32_t out_offset,
     const int32_t out_mult, const int32_t out_shift, const int32_t out_activation_min, const int32_t out_activation_max)
 {
-  uint32_t t0 = tic_us();
-  capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_add_s8(
-      input1_data, input1_dims, input2_data, input2_dims, input1_offset, input1_mult, input1_shift, input2_offset,
-      input2_mult, input2_shift, left_shift, output_data, output_dims, out_offset, out_mult, out_shift,
-      out_activation_min, out_activation_max);
-  capture_end_counters_and_log("arm_add_s8", toc_us(t0), rc);
-  log_kernel("arm_add_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_binary(&shape, input1_dims, input2_dims, output_dims, sizeof(int8_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_add_s8, &shape, output_data == input1_data || output_data == input2_data, rc,
+      __real_arm_add_s8(
+          input1_data, input1_dims, input2_data, input2_dims, input1_offset, input1_mult, input1_shift, input2_offset,
+          input2_mult, input2_shift, left_shift, output_data, output_dims, out_offset, out_mult, out_shift,
+          out_activation_min, out_activation_max));
   return rc;
 }
 
@@ -231,27 +1468,109 @@ arm_cmsis_nn_status __wrap_arm_avgpool_s16(
     const cmsis_nn_context *ctx, const cmsis_nn_pool_params *pool_params, const cmsis_nn_dims *input_dims,
     const int16_t *input_data, const cmsis_nn_dims *filter_dims, const cmsis_nn_dims *output_dims, int16_t *output_data)
 {
-  uint32_t t0 = tic_us();
-  arm_cmsis_nn_status rc =
-      __real_arm_avgpool_s16(ctx, pool_params, input_dims, input_data, filter_dims, output_dims, output_data);
-  log_kernel("arm_avgpool_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_pool(&shape, pool_params, input_dims, filter_dims, output_dims, sizeof(int16_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_avgpool_s16, &shape, output_data == input_data, rc,
+      __real_arm_avgpool_s16(ctx, pool_params, input_dims, input_data, filter_dims, output_dims, output_data));
   return rc;
 }
 
+// arm_avgpool_s16_get_buffer_size
+int32_t __real_arm_avgpool_s16_get_buffer_size(const int dim_dst_width, const int ch_src);
+
+int32_t __wrap_arm_avgpool_s16_get_buffer_size(const int dim_dst_width, const int ch_src)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_avgpool_s16_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_avgpool_s16_get_buffer_size(dim_dst_width, ch_src), ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_avgpool_s16_get_buffer_size_dsp
+int32_t __real_arm_avgpool_s16_get_buffer_size_dsp(const int dim_dst_width, const int ch_src);
+
+int32_t __wrap_arm_avgpool_s16_get_buffer_size_dsp(const int dim_dst_width, const int ch_src)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_avgpool_s16_get_buffer_size_dsp, NULL, false, rc,
+      (ret = __real_arm_avgpool_s16_get_buffer_size_dsp(dim_dst_width, ch_src), ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_avgpool_s16_get_buffer_size_mve
+int32_t __real_arm_avgpool_s16_get_buffer_size_mve(const int dim_dst_width, const int ch_src);
+
+int32_t __wrap_arm_avgpool_s16_get_buffer_size_mve(const int dim_dst_width, const int ch_src)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_avgpool_s16_get_buffer_size_mve, NULL, false, rc,
+      (ret = __real_arm_avgpool_s16_get_buffer_size_mve(dim_dst_width, ch_src), ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
 // arm_avgpool_s8
 arm_cmsis_nn_status __real_arm_avgpool_s8(
     const cmsis_nn_context *ctx, const cmsis_nn_pool_params *pool_params, const cmsis_nn_dims *input_dims,
     const int8_t *input_data, const cmsis_nn_dims *filter_dims, const cmsis_nn_dims *output_dims, int8_t *output_data);
 
-arm_cmsis_nn_status __wrap_arm_avgpool_s8(
-    const cmsis_nn_context *ctx, const cmsis_nn_pool_params *pool_params, const cmsis_nn_dims *input_dims,
-    const int8_t *input_data, const cmsis_nn_dims *filter_dims, const cmsis_nn_dims *output_dims, int8_t *output_data)
+arm_cmsis_nn_status __wrap_arm_avgpool_s8(
+    const cmsis_nn_context *ctx, const cmsis_nn_pool_params *pool_params, const cmsis_nn_dims *input_dims,
+    const int8_t *input_data, const cmsis_nn_dims *filter_dims, const cmsis_nn_dims *output_dims, int8_t *output_data)
+{
+  kernel_shape_record_t shape;
+  shape_pool(&shape, pool_params, input_dims, filter_dims, output_dims, sizeof(int8_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_avgpool_s8, &shape, output_data == input_data, rc,
+      __real_arm_avgpool_s8(ctx, pool_params, input_dims, input_data, filter_dims, output_dims, output_data));
+  return rc;
+}
+
+// arm_avgpool_s8_get_buffer_size
+int32_t __real_arm_avgpool_s8_get_buffer_size(const int dim_dst_width, const int ch_src);
+
+int32_t __wrap_arm_avgpool_s8_get_buffer_size(const int dim_dst_width, const int ch_src)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_avgpool_s8_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_avgpool_s8_get_buffer_size(dim_dst_width, ch_src), ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_avgpool_s8_get_buffer_size_dsp
+int32_t __real_arm_avgpool_s8_get_buffer_size_dsp(const int dim_dst_width, const int ch_src);
+
+int32_t __wrap_arm_avgpool_s8_get_buffer_size_dsp(const int dim_dst_width, const int ch_src)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_avgpool_s8_get_buffer_size_dsp, NULL, false, rc,
+      (ret = __real_arm_avgpool_s8_get_buffer_size_dsp(dim_dst_width, ch_src), ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_avgpool_s8_get_buffer_size_mve
+int32_t __real_arm_avgpool_s8_get_buffer_size_mve(const int dim_dst_width, const int ch_src);
+
+int32_t __wrap_arm_avgpool_s8_get_buffer_size_mve(const int dim_dst_width, const int ch_src)
 {
-  uint32_t t0 = tic_us();
-  arm_cmsis_nn_status rc =
-      __real_arm_avgpool_s8(ctx, pool_params, input_dims, input_data, filter_dims, output_dims, output_data);
-  log_kernel("arm_avgpool_s8", toc_us(t0));
-  return rc;
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_avgpool_s8_get_buffer_size_mve, NULL, false, rc,
+      (ret = __real_arm_avgpool_s8_get_buffer_size_mve(dim_dst_width, ch_src), ARM_CMSIS_NN_SUCCESS));
+  return ret;
 }
 
 // arm_batch_matmul_s16
@@ -265,12 +1584,13 @@ arm_cmsis_nn_status __wrap_arm_batch_matmul_s16(
     const cmsis_nn_per_tensor_quant_params *quant_params, const cmsis_nn_dims *input_lhs_dims, const int16_t *input_lhs,
     const cmsis_nn_dims *input_rhs_dims, const int16_t *input_rhs, const cmsis_nn_dims *output_dims, int16_t *output)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_batch_matmul_s16(
-      ctx, bmm_params, quant_params, input_lhs_dims, input_lhs, input_rhs_dims, input_rhs, output_dims, output);
-  capture_end_counters_and_log("arm_batch_matmul_s16", toc_us(t0), rc);
-  log_kernel("arm_batch_matmul_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_bmm(&shape, input_lhs_dims, input_rhs_dims, output_dims, sizeof(int16_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_batch_matmul_s16, &shape, output == input_lhs || output == input_rhs, rc,
+      __real_arm_batch_matmul_s16(
+          ctx, bmm_params, quant_params, input_lhs_dims, input_lhs, input_rhs_dims, input_rhs, output_dims, output));
   return rc;
 }
 
@@ -285,12 +1605,13 @@ arm_cmsis_nn_status __wrap_arm_batch_matmul_s8(
     const cmsis_nn_per_tensor_quant_params *quant_params, const cmsis_nn_dims *input_lhs_dims, const int8_t *input_lhs,
     const cmsis_nn_dims *input_rhs_dims, const int8_t *input_rhs, const cmsis_nn_dims *output_dims, int8_t *output)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_batch_matmul_s8(
-      ctx, bmm_params, quant_params, input_lhs_dims, input_lhs, input_rhs_dims, input_rhs, output_dims, output);
-  capture_end_counters_and_log("arm_batch_matmul_s8", toc_us(t0), rc);
-  log_kernel("arm_batch_matmul_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_bmm(&shape, input_lhs_dims, input_rhs_dims, output_dims, sizeof(int8_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_batch_matmul_s8, &shape, output == input_lhs || output == input_rhs, rc,
+      __real_arm_batch_matmul_s8(
+          ctx, bmm_params, quant_params, input_lhs_dims, input_lhs, input_rhs_dims, input_rhs, output_dims, output));
   return rc;
 }
 
@@ -307,16 +1628,37 @@ arm_cmsis_nn_status __wrap_arm_convolve_1_x_n_s4(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_convolve_1_x_n_s4(
-      ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_convolve_1_x_n_s4", toc_us(t0), rc);
-  log_kernel("arm_convolve_1_x_n_s4", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_CONV, input_dims, filter_dims, output_dims, &conv_params->stride, &conv_params->padding,
+      &conv_params->dilation, sizeof(int8_t), 4, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_1_x_n_s4, &shape, output_data == input_data, rc,
+      __real_arm_convolve_1_x_n_s4(
+          ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
+          bias_data, output_dims, output_data));
   return rc;
 }
 
+// arm_convolve_1_x_n_s4_get_buffer_size
+int32_t __real_arm_convolve_1_x_n_s4_get_buffer_size(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims);
+
+int32_t __wrap_arm_convolve_1_x_n_s4_get_buffer_size(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_1_x_n_s4_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_convolve_1_x_n_s4_get_buffer_size(conv_params, input_dims, filter_dims, output_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
 // arm_convolve_1_x_n_s8
 arm_cmsis_nn_status __real_arm_convolve_1_x_n_s8(
     const cmsis_nn_context *ctx, const cmsis_nn_context *weight_sum_ctx, const cmsis_nn_conv_params *conv_params,
@@ -330,16 +1672,37 @@ arm_cmsis_nn_status __wrap_arm_convolve_1_x_n_s8(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_convolve_1_x_n_s8(
-      ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_convolve_1_x_n_s8", toc_us(t0), rc);
-  log_kernel("arm_convolve_1_x_n_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_CONV, input_dims, filter_dims, output_dims, &conv_params->stride, &conv_params->padding,
+      &conv_params->dilation, sizeof(int8_t), 8, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_1_x_n_s8, &shape, output_data == input_data, rc,
+      __real_arm_convolve_1_x_n_s8(
+          ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
+          bias_data, output_dims, output_data));
   return rc;
 }
 
+// arm_convolve_1_x_n_s8_get_buffer_size
+int32_t __real_arm_convolve_1_x_n_s8_get_buffer_size(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims);
+
+int32_t __wrap_arm_convolve_1_x_n_s8_get_buffer_size(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_1_x_n_s8_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_convolve_1_x_n_s8_get_buffer_size(conv_params, input_dims, filter_dims, output_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
 // arm_convolve_1x1_s4
 arm_cmsis_nn_status __real_arm_convolve_1x1_s4(
     const cmsis_nn_context *ctx, const cmsis_nn_context *weight_sum_ctx, const cmsis_nn_conv_params *conv_params,
@@ -353,13 +1716,16 @@ arm_cmsis_nn_status __wrap_arm_convolve_1x1_s4(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_convolve_1x1_s4(
-      ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_convolve_1x1_s4", toc_us(t0), rc);
-  log_kernel("arm_convolve_1x1_s4", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_CONV, input_dims, filter_dims, output_dims, &conv_params->stride, &conv_params->padding,
+      &conv_params->dilation, sizeof(int8_t), 4, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_1x1_s4, &shape, output_data == input_data, rc,
+      __real_arm_convolve_1x1_s4(
+          ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
+          bias_data, output_dims, output_data));
   return rc;
 }
 
@@ -376,16 +1742,32 @@ arm_cmsis_nn_status __wrap_arm_convolve_1x1_s4_fast(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_convolve_1x1_s4_fast(
-      ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_convolve_1x1_s4_fast", toc_us(t0), rc);
-  log_kernel("arm_convolve_1x1_s4_fast", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_CONV, input_dims, filter_dims, output_dims, &conv_params->stride, &conv_params->padding,
+      &conv_params->dilation, sizeof(int8_t), 4, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_1x1_s4_fast, &shape, output_data == input_data, rc,
+      __real_arm_convolve_1x1_s4_fast(
+          ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
+          bias_data, output_dims, output_data));
   return rc;
 }
 
+// arm_convolve_1x1_s4_fast_get_buffer_size
+int32_t __real_arm_convolve_1x1_s4_fast_get_buffer_size(const cmsis_nn_dims *input_dims);
+
+int32_t __wrap_arm_convolve_1x1_s4_fast_get_buffer_size(const cmsis_nn_dims *input_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_1x1_s4_fast_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_convolve_1x1_s4_fast_get_buffer_size(input_dims), ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
 // arm_convolve_1x1_s8
 arm_cmsis_nn_status __real_arm_convolve_1x1_s8(
     const cmsis_nn_context *ctx, const cmsis_nn_context *weight_sum_ctx, const cmsis_nn_conv_params *conv_params,
@@ -399,13 +1781,16 @@ arm_cmsis_nn_status __wrap_arm_convolve_1x1_s8(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_convolve_1x1_s8(
-      ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_convolve_1x1_s8", toc_us(t0), rc);
-  log_kernel("arm_convolve_1x1_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_CONV, input_dims, filter_dims, output_dims, &conv_params->stride, &conv_params->padding,
+      &conv_params->dilation, sizeof(int8_t), 8, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_1x1_s8, &shape, output_data == input_data, rc,
+      __real_arm_convolve_1x1_s8(
+          ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
+          bias_data, output_dims, output_data));
   return rc;
 }
 
@@ -422,16 +1807,32 @@ arm_cmsis_nn_status __wrap_arm_convolve_1x1_s8_fast(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_convolve_1x1_s8_fast(
-      ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_convolve_1x1_s8_fast", toc_us(t0), rc);
-  log_kernel("arm_convolve_1x1_s8_fast", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_CONV, input_dims, filter_dims, output_dims, &conv_params->stride, &conv_params->padding,
+      &conv_params->dilation, sizeof(int8_t), 8, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_1x1_s8_fast, &shape, output_data == input_data, rc,
+      __real_arm_convolve_1x1_s8_fast(
+          ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
+          bias_data, output_dims, output_data));
   return rc;
 }
 
+// arm_convolve_1x1_s8_fast_get_buffer_size
+int32_t __real_arm_convolve_1x1_s8_fast_get_buffer_size(const cmsis_nn_dims *input_dims);
+
+int32_t __wrap_arm_convolve_1x1_s8_fast_get_buffer_size(const cmsis_nn_dims *input_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_1x1_s8_fast_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_convolve_1x1_s8_fast_get_buffer_size(input_dims), ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
 // arm_convolve_s16
 arm_cmsis_nn_status __real_arm_convolve_s16(
     const cmsis_nn_context *ctx, const cmsis_nn_context *weight_sum_ctx, const cmsis_nn_conv_params *conv_params,
@@ -445,16 +1846,33 @@ arm_cmsis_nn_status __wrap_arm_convolve_s16(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const cmsis_nn_bias_data *bias_data, const cmsis_nn_dims *output_dims, int16_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_convolve_s16(
-      ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_convolve_s16", toc_us(t0), rc);
-  log_kernel("arm_convolve_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_CONV, input_dims, filter_dims, output_dims, &conv_params->stride, &conv_params->padding,
+      &conv_params->dilation, sizeof(int16_t), 8,
+      bias_data && bias_data->is_int32_bias ? sizeof(int32_t) : sizeof(int64_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_s16, &shape, output_data == input_data, rc,
+      __real_arm_convolve_s16(
+          ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
+          bias_data, output_dims, output_data));
   return rc;
 }
 
+// arm_convolve_s16_get_buffer_size
+int32_t __real_arm_convolve_s16_get_buffer_size(const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims);
+
+int32_t __wrap_arm_convolve_s16_get_buffer_size(const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_s16_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_convolve_s16_get_buffer_size(input_dims, filter_dims), ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
 // arm_convolve_s4
 arm_cmsis_nn_status __real_arm_convolve_s4(
     const cmsis_nn_context *ctx, const cmsis_nn_context *weight_sum_ctx, const cmsis_nn_conv_params *conv_params,
@@ -468,16 +1886,32 @@ arm_cmsis_nn_status __wrap_arm_convolve_s4(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_convolve_s4(
-      ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_convolve_s4", toc_us(t0), rc);
-  log_kernel("arm_convolve_s4", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_CONV, input_dims, filter_dims, output_dims, &conv_params->stride, &conv_params->padding,
+      &conv_params->dilation, sizeof(int8_t), 4, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_s4, &shape, output_data == input_data, rc,
+      __real_arm_convolve_s4(
+          ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
+          bias_data, output_dims, output_data));
   return rc;
 }
 
+// arm_convolve_s4_get_buffer_size
+int32_t __real_arm_convolve_s4_get_buffer_size(const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims);
+
+int32_t __wrap_arm_convolve_s4_get_buffer_size(const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_s4_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_convolve_s4_get_buffer_size(input_dims, filter_dims), ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
 // arm_convolve_s8
 arm_cmsis_nn_status __real_arm_convolve_s8(
     const cmsis_nn_context *ctx, const cmsis_nn_context *weight_sum_ctx, const cmsis_nn_conv_params *conv_params,
@@ -491,16 +1925,32 @@ arm_cmsis_nn_status __wrap_arm_convolve_s8(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *upscale_dims, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_convolve_s8(
-      ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, upscale_dims, output_dims, output_data);
-  capture_end_counters_and_log("arm_convolve_s8", toc_us(t0), rc);
-  log_kernel("arm_convolve_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_CONV, input_dims, filter_dims, output_dims, &conv_params->stride, &conv_params->padding,
+      &conv_params->dilation, sizeof(int8_t), 8, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_s8, &shape, output_data == input_data, rc,
+      __real_arm_convolve_s8(
+          ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
+          bias_data, upscale_dims, output_dims, output_data));
   return rc;
 }
 
+// arm_convolve_s8_get_buffer_size
+int32_t __real_arm_convolve_s8_get_buffer_size(const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims);
+
+int32_t __wrap_arm_convolve_s8_get_buffer_size(const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_s8_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_convolve_s8_get_buffer_size(input_dims, filter_dims), ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
 // arm_convolve_weight_sum
 arm_cmsis_nn_status __real_arm_convolve_weight_sum(
     int32_t *vector_sum_buf, const int8_t *rhs, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
@@ -510,10 +1960,12 @@ arm_cmsis_nn_status __wrap_arm_convolve_weight_sum(
     int32_t *vector_sum_buf, const int8_t *rhs, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
     const cmsis_nn_dims *output_dims, const int32_t lhs_offset, const int32_t *bias_data)
 {
-  uint32_t t0 = tic_us();
-  arm_cmsis_nn_status rc =
-      __real_arm_convolve_weight_sum(vector_sum_buf, rhs, input_dims, filter_dims, output_dims, lhs_offset, bias_data);
-  log_kernel("arm_convolve_weight_sum", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_weight_sum(&shape, filter_dims->n, filter_dims->h * filter_dims->w * filter_dims->c, 8);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_weight_sum, &shape, false, rc,
+      __real_arm_convolve_weight_sum(vector_sum_buf, rhs, input_dims, filter_dims, output_dims, lhs_offset, bias_data));
   return rc;
 }
 
@@ -528,12 +1980,13 @@ arm_cmsis_nn_status __wrap_arm_convolve_weight_sum_s4(
     const cmsis_nn_dims *filter_dims, const cmsis_nn_dims *output_dims, const int32_t lhs_offset,
     const int32_t *bias_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_convolve_weight_sum_s4(
-      vector_sum_buf, weights_s4, input_dims, filter_dims, output_dims, lhs_offset, bias_data);
-  capture_end_counters_and_log("arm_convolve_weight_sum_s4", toc_us(t0), rc);
-  log_kernel("arm_convolve_weight_sum_s4", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_weight_sum(&shape, filter_dims->n, filter_dims->h * filter_dims->w * filter_dims->c, 4);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_weight_sum_s4, &shape, false, rc,
+      __real_arm_convolve_weight_sum_s4(
+          vector_sum_buf, weights_s4, input_dims, filter_dims, output_dims, lhs_offset, bias_data));
   return rc;
 }
 
@@ -550,16 +2003,74 @@ arm_cmsis_nn_status __wrap_arm_convolve_wrapper_s16(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const cmsis_nn_bias_data *bias_data, const cmsis_nn_dims *output_dims, int16_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_convolve_wrapper_s16(
-      ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_convolve_wrapper_s16", toc_us(t0), rc);
-  log_kernel("arm_convolve_wrapper_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_CONV, input_dims, filter_dims, output_dims, &conv_params->stride, &conv_params->padding,
+      &conv_params->dilation, sizeof(int16_t), 8,
+      bias_data && bias_data->is_int32_bias ? sizeof(int32_t) : sizeof(int64_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_wrapper_s16, &shape, output_data == input_data, rc,
+      __real_arm_convolve_wrapper_s16(
+          ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
+          bias_data, output_dims, output_data));
   return rc;
 }
 
+// arm_convolve_wrapper_s16_get_buffer_size
+int32_t __real_arm_convolve_wrapper_s16_get_buffer_size(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims);
+
+int32_t __wrap_arm_convolve_wrapper_s16_get_buffer_size(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_wrapper_s16_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_convolve_wrapper_s16_get_buffer_size(conv_params, input_dims, filter_dims, output_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_convolve_wrapper_s16_get_buffer_size_dsp
+int32_t __real_arm_convolve_wrapper_s16_get_buffer_size_dsp(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims);
+
+int32_t __wrap_arm_convolve_wrapper_s16_get_buffer_size_dsp(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_wrapper_s16_get_buffer_size_dsp, NULL, false, rc,
+      (ret = __real_arm_convolve_wrapper_s16_get_buffer_size_dsp(conv_params, input_dims, filter_dims, output_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_convolve_wrapper_s16_get_buffer_size_mve
+int32_t __real_arm_convolve_wrapper_s16_get_buffer_size_mve(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims);
+
+int32_t __wrap_arm_convolve_wrapper_s16_get_buffer_size_mve(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_wrapper_s16_get_buffer_size_mve, NULL, false, rc,
+      (ret = __real_arm_convolve_wrapper_s16_get_buffer_size_mve(conv_params, input_dims, filter_dims, output_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
 // arm_convolve_wrapper_s4
 arm_cmsis_nn_status __real_arm_convolve_wrapper_s4(
     const cmsis_nn_context *ctx, const cmsis_nn_context *weight_sum_ctx, const cmsis_nn_conv_params *conv_params,
@@ -573,16 +2084,73 @@ arm_cmsis_nn_status __wrap_arm_convolve_wrapper_s4(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_convolve_wrapper_s4(
-      ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_convolve_wrapper_s4", toc_us(t0), rc);
-  log_kernel("arm_convolve_wrapper_s4", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_CONV, input_dims, filter_dims, output_dims, &conv_params->stride, &conv_params->padding,
+      &conv_params->dilation, sizeof(int8_t), 4, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_wrapper_s4, &shape, output_data == input_data, rc,
+      __real_arm_convolve_wrapper_s4(
+          ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
+          bias_data, output_dims, output_data));
   return rc;
 }
 
+// arm_convolve_wrapper_s4_get_buffer_size
+int32_t __real_arm_convolve_wrapper_s4_get_buffer_size(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims);
+
+int32_t __wrap_arm_convolve_wrapper_s4_get_buffer_size(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_wrapper_s4_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_convolve_wrapper_s4_get_buffer_size(conv_params, input_dims, filter_dims, output_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_convolve_wrapper_s4_get_buffer_size_dsp
+int32_t __real_arm_convolve_wrapper_s4_get_buffer_size_dsp(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims);
+
+int32_t __wrap_arm_convolve_wrapper_s4_get_buffer_size_dsp(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_wrapper_s4_get_buffer_size_dsp, NULL, false, rc,
+      (ret = __real_arm_convolve_wrapper_s4_get_buffer_size_dsp(conv_params, input_dims, filter_dims, output_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_convolve_wrapper_s4_get_buffer_size_mve
+int32_t __real_arm_convolve_wrapper_s4_get_buffer_size_mve(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims);
+
+int32_t __wrap_arm_convolve_wrapper_s4_get_buffer_size_mve(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_wrapper_s4_get_buffer_size_mve, NULL, false, rc,
+      (ret = __real_arm_convolve_wrapper_s4_get_buffer_size_mve(conv_params, input_dims, filter_dims, output_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
 // arm_convolve_wrapper_s8
 arm_cmsis_nn_status __real_arm_convolve_wrapper_s8(
     const cmsis_nn_context *ctx, const cmsis_nn_context *weight_sum_ctx, const cmsis_nn_conv_params *conv_params,
@@ -596,16 +2164,73 @@ arm_cmsis_nn_status __wrap_arm_convolve_wrapper_s8(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_convolve_wrapper_s8(
-      ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_convolve_wrapper_s8", toc_us(t0), rc);
-  log_kernel("arm_convolve_wrapper_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_CONV, input_dims, filter_dims, output_dims, &conv_params->stride, &conv_params->padding,
+      &conv_params->dilation, sizeof(int8_t), 8, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_wrapper_s8, &shape, output_data == input_data, rc,
+      __real_arm_convolve_wrapper_s8(
+          ctx, weight_sum_ctx, conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
+          bias_data, output_dims, output_data));
   return rc;
 }
 
+// arm_convolve_wrapper_s8_get_buffer_size
+int32_t __real_arm_convolve_wrapper_s8_get_buffer_size(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims);
+
+int32_t __wrap_arm_convolve_wrapper_s8_get_buffer_size(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_wrapper_s8_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_convolve_wrapper_s8_get_buffer_size(conv_params, input_dims, filter_dims, output_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_convolve_wrapper_s8_get_buffer_size_dsp
+int32_t __real_arm_convolve_wrapper_s8_get_buffer_size_dsp(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims);
+
+int32_t __wrap_arm_convolve_wrapper_s8_get_buffer_size_dsp(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_wrapper_s8_get_buffer_size_dsp, NULL, false, rc,
+      (ret = __real_arm_convolve_wrapper_s8_get_buffer_size_dsp(conv_params, input_dims, filter_dims, output_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_convolve_wrapper_s8_get_buffer_size_mve
+int32_t __real_arm_convolve_wrapper_s8_get_buffer_size_mve(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims);
+
+int32_t __wrap_arm_convolve_wrapper_s8_get_buffer_size_mve(
+    const cmsis_nn_conv_params *conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_convolve_wrapper_s8_get_buffer_size_mve, NULL, false, rc,
+      (ret = __real_arm_convolve_wrapper_s8_get_buffer_size_mve(conv_params, input_dims, filter_dims, output_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
 // arm_depthwise_conv_3x3_s8
 arm_cmsis_nn_status __real_arm_depthwise_conv_3x3_s8(
     const cmsis_nn_context *ctx, const cmsis_nn_context *weight_sum_ctx, const cmsis_nn_dw_conv_params *dw_conv_params,
@@ -619,13 +2244,16 @@ arm_cmsis_nn_status __wrap_arm_depthwise_conv_3x3_s8(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_depthwise_conv_3x3_s8(
-      ctx, weight_sum_ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_depthwise_conv_3x3_s8", toc_us(t0), rc);
-  log_kernel("arm_depthwise_conv_3x3_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_DEPTHWISE, input_dims, filter_dims, output_dims, &dw_conv_params->stride, &dw_conv_params->padding,
+      &dw_conv_params->dilation, sizeof(int8_t), 8, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_3x3_s8, &shape, output_data == input_data, rc,
+      __real_arm_depthwise_conv_3x3_s8(
+          ctx, weight_sum_ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data,
+          bias_dims, bias_data, output_dims, output_data));
   return rc;
 }
 
@@ -642,16 +2270,34 @@ arm_cmsis_nn_status __wrap_arm_depthwise_conv_fast_s16(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int64_t *bias_data, const cmsis_nn_dims *output_dims, int16_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_depthwise_conv_fast_s16(
-      ctx, weight_sum_ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_depthwise_conv_fast_s16", toc_us(t0), rc);
-  log_kernel("arm_depthwise_conv_fast_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_DEPTHWISE, input_dims, filter_dims, output_dims, &dw_conv_params->stride, &dw_conv_params->padding,
+      &dw_conv_params->dilation, sizeof(int16_t), 8, sizeof(int64_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_fast_s16, &shape, output_data == input_data, rc,
+      __real_arm_depthwise_conv_fast_s16(
+          ctx, weight_sum_ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data,
+          bias_dims, bias_data, output_dims, output_data));
   return rc;
 }
 
+// arm_depthwise_conv_fast_s16_get_buffer_size
+int32_t
+__real_arm_depthwise_conv_fast_s16_get_buffer_size(const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims);
+
+int32_t
+__wrap_arm_depthwise_conv_fast_s16_get_buffer_size(const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_fast_s16_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_depthwise_conv_fast_s16_get_buffer_size(input_dims, filter_dims), ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
 // arm_depthwise_conv_s16
 arm_cmsis_nn_status __real_arm_depthwise_conv_s16(
     const cmsis_nn_context *ctx, const cmsis_nn_context *weight_sum_ctx, const cmsis_nn_dw_conv_params *dw_conv_params,
@@ -665,13 +2311,16 @@ arm_cmsis_nn_status __wrap_arm_depthwise_conv_s16(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int64_t *bias_data, const cmsis_nn_dims *output_dims, int16_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_depthwise_conv_s16(
-      ctx, weight_sum_ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_depthwise_conv_s16", toc_us(t0), rc);
-  log_kernel("arm_depthwise_conv_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_DEPTHWISE, input_dims, filter_dims, output_dims, &dw_conv_params->stride, &dw_conv_params->padding,
+      &dw_conv_params->dilation, sizeof(int16_t), 8, sizeof(int64_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_s16, &shape, output_data == input_data, rc,
+      __real_arm_depthwise_conv_s16(
+          ctx, weight_sum_ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data,
+          bias_dims, bias_data, output_dims, output_data));
   return rc;
 }
 
@@ -688,59 +2337,83 @@ arm_cmsis_nn_status __wrap_arm_depthwise_conv_s4(
     const cmsis_nn_dims *filter_dims, const int8_t *kernel, const cmsis_nn_dims *bias_dims, const int32_t *bias,
     const cmsis_nn_dims *output_dims, int8_t *output)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_depthwise_conv_s4(
-      ctx, weight_sum_ctx, dw_conv_params, quant_params, input_dims, input, filter_dims, kernel, bias_dims, bias,
-      output_dims, output);
-  capture_end_counters_and_log("arm_depthwise_conv_s4", toc_us(t0), rc);
-  log_kernel("arm_depthwise_conv_s4", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_DEPTHWISE, input_dims, filter_dims, output_dims, &dw_conv_params->stride, &dw_conv_params->padding,
+      &dw_conv_params->dilation, sizeof(int8_t), 4, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_s4, &shape, output == input, rc,
+      __real_arm_depthwise_conv_s4(
+          ctx, weight_sum_ctx, dw_conv_params, quant_params, input_dims, input, filter_dims, kernel, bias_dims, bias,
+          output_dims, output));
   return rc;
 }
 
-// arm_depthwise_conv_s8
-arm_cmsis_nn_status __real_arm_depthwise_conv_s8(
+// arm_depthwise_conv_s4_opt
+arm_cmsis_nn_status __real_arm_depthwise_conv_s4_opt(
     const cmsis_nn_context *ctx, const cmsis_nn_context *weight_sum_ctx, const cmsis_nn_dw_conv_params *dw_conv_params,
     const cmsis_nn_per_channel_quant_params *quant_params, const cmsis_nn_dims *input_dims, const int8_t *input_data,
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data);
 
-arm_cmsis_nn_status __wrap_arm_depthwise_conv_s8(
+arm_cmsis_nn_status __wrap_arm_depthwise_conv_s4_opt(
     const cmsis_nn_context *ctx, const cmsis_nn_context *weight_sum_ctx, const cmsis_nn_dw_conv_params *dw_conv_params,
     const cmsis_nn_per_channel_quant_params *quant_params, const cmsis_nn_dims *input_dims, const int8_t *input_data,
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_depthwise_conv_s8(
-      ctx, weight_sum_ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_depthwise_conv_s8", toc_us(t0), rc);
-  log_kernel("arm_depthwise_conv_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_DEPTHWISE, input_dims, filter_dims, output_dims, &dw_conv_params->stride, &dw_conv_params->padding,
+      &dw_conv_params->dilation, sizeof(int8_t), 4, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_s4_opt, &shape, output_data == input_data, rc,
+      __real_arm_depthwise_conv_s4_opt(
+          ctx, weight_sum_ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data,
+          bias_dims, bias_data, output_dims, output_data));
   return rc;
 }
 
-// arm_depthwise_conv_s4_opt
-arm_cmsis_nn_status __real_arm_depthwise_conv_s4_opt(
+// arm_depthwise_conv_s4_opt_get_buffer_size
+int32_t
+__real_arm_depthwise_conv_s4_opt_get_buffer_size(const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims);
+
+int32_t
+__wrap_arm_depthwise_conv_s4_opt_get_buffer_size(const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_s4_opt_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_depthwise_conv_s4_opt_get_buffer_size(input_dims, filter_dims), ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_depthwise_conv_s8
+arm_cmsis_nn_status __real_arm_depthwise_conv_s8(
     const cmsis_nn_context *ctx, const cmsis_nn_context *weight_sum_ctx, const cmsis_nn_dw_conv_params *dw_conv_params,
     const cmsis_nn_per_channel_quant_params *quant_params, const cmsis_nn_dims *input_dims, const int8_t *input_data,
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data);
 
-arm_cmsis_nn_status __wrap_arm_depthwise_conv_s4_opt(
+arm_cmsis_nn_status __wrap_arm_depthwise_conv_s8(
     const cmsis_nn_context *ctx, const cmsis_nn_context *weight_sum_ctx, const cmsis_nn_dw_conv_params *dw_conv_params,
     const cmsis_nn_per_channel_quant_params *quant_params, const cmsis_nn_dims *input_dims, const int8_t *input_data,
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_depthwise_conv_s4_opt(
-      ctx, weight_sum_ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_depthwise_conv_s4_opt", toc_us(t0), rc);
-  log_kernel("arm_depthwise_conv_s4_opt", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_DEPTHWISE, input_dims, filter_dims, output_dims, &dw_conv_params->stride, &dw_conv_params->padding,
+      &dw_conv_params->dilation, sizeof(int8_t), 8, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_s8, &shape, output_data == input_data, rc,
+      __real_arm_depthwise_conv_s8(
+          ctx, weight_sum_ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data,
+          bias_dims, bias_data, output_dims, output_data));
   return rc;
 }
 
@@ -757,16 +2430,34 @@ arm_cmsis_nn_status __wrap_arm_depthwise_conv_s8_opt(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_depthwise_conv_s8_opt(
-      ctx, weight_sum_ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_depthwise_conv_s8_opt", toc_us(t0), rc);
-  log_kernel("arm_depthwise_conv_s8_opt", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_DEPTHWISE, input_dims, filter_dims, output_dims, &dw_conv_params->stride, &dw_conv_params->padding,
+      &dw_conv_params->dilation, sizeof(int8_t), 8, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_s8_opt, &shape, output_data == input_data, rc,
+      __real_arm_depthwise_conv_s8_opt(
+          ctx, weight_sum_ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data,
+          bias_dims, bias_data, output_dims, output_data));
   return rc;
 }
 
+// arm_depthwise_conv_s8_opt_get_buffer_size
+int32_t
+__real_arm_depthwise_conv_s8_opt_get_buffer_size(const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims);
+
+int32_t
+__wrap_arm_depthwise_conv_s8_opt_get_buffer_size(const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_s8_opt_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_depthwise_conv_s8_opt_get_buffer_size(input_dims, filter_dims), ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
 // arm_depthwise_conv_wrapper_s16
 arm_cmsis_nn_status __real_arm_depthwise_conv_wrapper_s16(
     const cmsis_nn_context *ctx, const cmsis_nn_context *weight_sum_ctx, const cmsis_nn_dw_conv_params *dw_conv_params,
@@ -780,16 +2471,76 @@ arm_cmsis_nn_status __wrap_arm_depthwise_conv_wrapper_s16(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int64_t *bias_data, const cmsis_nn_dims *output_dims, int16_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_depthwise_conv_wrapper_s16(
-      ctx, weight_sum_ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_depthwise_conv_wrapper_s16", toc_us(t0), rc);
-  log_kernel("arm_depthwise_conv_wrapper_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_DEPTHWISE, input_dims, filter_dims, output_dims, &dw_conv_params->stride, &dw_conv_params->padding,
+      &dw_conv_params->dilation, sizeof(int16_t), 8, sizeof(int64_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_wrapper_s16, &shape, output_data == input_data, rc,
+      __real_arm_depthwise_conv_wrapper_s16(
+          ctx, weight_sum_ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data,
+          bias_dims, bias_data, output_dims, output_data));
   return rc;
 }
 
+// arm_depthwise_conv_wrapper_s16_get_buffer_size
+int32_t __real_arm_depthwise_conv_wrapper_s16_get_buffer_size(
+    const cmsis_nn_dw_conv_params *dw_conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims);
+
+int32_t __wrap_arm_depthwise_conv_wrapper_s16_get_buffer_size(
+    const cmsis_nn_dw_conv_params *dw_conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_wrapper_s16_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_depthwise_conv_wrapper_s16_get_buffer_size(
+          dw_conv_params, input_dims, filter_dims, output_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_depthwise_conv_wrapper_s16_get_buffer_size_dsp
+int32_t __real_arm_depthwise_conv_wrapper_s16_get_buffer_size_dsp(
+    const cmsis_nn_dw_conv_params *dw_conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims);
+
+int32_t __wrap_arm_depthwise_conv_wrapper_s16_get_buffer_size_dsp(
+    const cmsis_nn_dw_conv_params *dw_conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_wrapper_s16_get_buffer_size_dsp, NULL, false, rc,
+      (ret = __real_arm_depthwise_conv_wrapper_s16_get_buffer_size_dsp(
+          dw_conv_params, input_dims, filter_dims, output_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_depthwise_conv_wrapper_s16_get_buffer_size_mve
+int32_t __real_arm_depthwise_conv_wrapper_s16_get_buffer_size_mve(
+    const cmsis_nn_dw_conv_params *dw_conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims);
+
+int32_t __wrap_arm_depthwise_conv_wrapper_s16_get_buffer_size_mve(
+    const cmsis_nn_dw_conv_params *dw_conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_wrapper_s16_get_buffer_size_mve, NULL, false, rc,
+      (ret = __real_arm_depthwise_conv_wrapper_s16_get_buffer_size_mve(
+          dw_conv_params, input_dims, filter_dims, output_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
 // arm_depthwise_conv_wrapper_s4
 arm_cmsis_nn_status __real_arm_depthwise_conv_wrapper_s4(
     const cmsis_nn_context *ctx, const cmsis_nn_context *weight_sum_ctx, const cmsis_nn_dw_conv_params *dw_conv_params,
@@ -803,16 +2554,75 @@ arm_cmsis_nn_status __wrap_arm_depthwise_conv_wrapper_s4(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_depthwise_conv_wrapper_s4(
-      ctx, weight_sum_ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_depthwise_conv_wrapper_s4", toc_us(t0), rc);
-  log_kernel("arm_depthwise_conv_wrapper_s4", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_DEPTHWISE, input_dims, filter_dims, output_dims, &dw_conv_params->stride, &dw_conv_params->padding,
+      &dw_conv_params->dilation, sizeof(int8_t), 4, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_wrapper_s4, &shape, output_data == input_data, rc,
+      __real_arm_depthwise_conv_wrapper_s4(
+          ctx, weight_sum_ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data,
+          bias_dims, bias_data, output_dims, output_data));
   return rc;
 }
 
+// arm_depthwise_conv_wrapper_s4_get_buffer_size
+int32_t __real_arm_depthwise_conv_wrapper_s4_get_buffer_size(
+    const cmsis_nn_dw_conv_params *dw_conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims);
+
+int32_t __wrap_arm_depthwise_conv_wrapper_s4_get_buffer_size(
+    const cmsis_nn_dw_conv_params *dw_conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_wrapper_s4_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_depthwise_conv_wrapper_s4_get_buffer_size(dw_conv_params, input_dims, filter_dims, output_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_depthwise_conv_wrapper_s4_get_buffer_size_dsp
+int32_t __real_arm_depthwise_conv_wrapper_s4_get_buffer_size_dsp(
+    const cmsis_nn_dw_conv_params *dw_conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims);
+
+int32_t __wrap_arm_depthwise_conv_wrapper_s4_get_buffer_size_dsp(
+    const cmsis_nn_dw_conv_params *dw_conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_wrapper_s4_get_buffer_size_dsp, NULL, false, rc,
+      (ret = __real_arm_depthwise_conv_wrapper_s4_get_buffer_size_dsp(
+          dw_conv_params, input_dims, filter_dims, output_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_depthwise_conv_wrapper_s4_get_buffer_size_mve
+int32_t __real_arm_depthwise_conv_wrapper_s4_get_buffer_size_mve(
+    const cmsis_nn_dw_conv_params *dw_conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims);
+
+int32_t __wrap_arm_depthwise_conv_wrapper_s4_get_buffer_size_mve(
+    const cmsis_nn_dw_conv_params *dw_conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_wrapper_s4_get_buffer_size_mve, NULL, false, rc,
+      (ret = __real_arm_depthwise_conv_wrapper_s4_get_buffer_size_mve(
+          dw_conv_params, input_dims, filter_dims, output_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
 // arm_depthwise_conv_wrapper_s8
 arm_cmsis_nn_status __real_arm_depthwise_conv_wrapper_s8(
     const cmsis_nn_context *ctx, const cmsis_nn_context *weight_sum_ctx, const cmsis_nn_dw_conv_params *dw_conv_params,
@@ -826,16 +2636,75 @@ arm_cmsis_nn_status __wrap_arm_depthwise_conv_wrapper_s8(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_depthwise_conv_wrapper_s8(
-      ctx, weight_sum_ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_depthwise_conv_wrapper_s8", toc_us(t0), rc);
-  log_kernel("arm_depthwise_conv_wrapper_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_DEPTHWISE, input_dims, filter_dims, output_dims, &dw_conv_params->stride, &dw_conv_params->padding,
+      &dw_conv_params->dilation, sizeof(int8_t), 8, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_wrapper_s8, &shape, output_data == input_data, rc,
+      __real_arm_depthwise_conv_wrapper_s8(
+          ctx, weight_sum_ctx, dw_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data,
+          bias_dims, bias_data, output_dims, output_data));
   return rc;
 }
 
+// arm_depthwise_conv_wrapper_s8_get_buffer_size
+int32_t __real_arm_depthwise_conv_wrapper_s8_get_buffer_size(
+    const cmsis_nn_dw_conv_params *dw_conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims);
+
+int32_t __wrap_arm_depthwise_conv_wrapper_s8_get_buffer_size(
+    const cmsis_nn_dw_conv_params *dw_conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_wrapper_s8_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_depthwise_conv_wrapper_s8_get_buffer_size(dw_conv_params, input_dims, filter_dims, output_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_depthwise_conv_wrapper_s8_get_buffer_size_dsp
+int32_t __real_arm_depthwise_conv_wrapper_s8_get_buffer_size_dsp(
+    const cmsis_nn_dw_conv_params *dw_conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims);
+
+int32_t __wrap_arm_depthwise_conv_wrapper_s8_get_buffer_size_dsp(
+    const cmsis_nn_dw_conv_params *dw_conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_wrapper_s8_get_buffer_size_dsp, NULL, false, rc,
+      (ret = __real_arm_depthwise_conv_wrapper_s8_get_buffer_size_dsp(
+          dw_conv_params, input_dims, filter_dims, output_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_depthwise_conv_wrapper_s8_get_buffer_size_mve
+int32_t __real_arm_depthwise_conv_wrapper_s8_get_buffer_size_mve(
+    const cmsis_nn_dw_conv_params *dw_conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims);
+
+int32_t __wrap_arm_depthwise_conv_wrapper_s8_get_buffer_size_mve(
+    const cmsis_nn_dw_conv_params *dw_conv_params, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims,
+    const cmsis_nn_dims *output_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_conv_wrapper_s8_get_buffer_size_mve, NULL, false, rc,
+      (ret = __real_arm_depthwise_conv_wrapper_s8_get_buffer_size_mve(
+          dw_conv_params, input_dims, filter_dims, output_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
 // arm_depthwise_convolve_weight_sum
 arm_cmsis_nn_status __real_arm_depthwise_convolve_weight_sum(
     int32_t *vector_sum_buf, int8_t *scratch_buf, const int8_t *rhs, const cmsis_nn_dw_conv_params *dw_conv_params,
@@ -847,12 +2716,14 @@ arm_cmsis_nn_status __wrap_arm_depthwise_convolve_weight_sum(
     const cmsis_nn_dims *input_dims, const cmsis_nn_dims *filter_dims, const cmsis_nn_dims *output_dims,
     const int32_t lhs_offset, const int32_t *bias_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_depthwise_convolve_weight_sum(
-      vector_sum_buf, scratch_buf, rhs, dw_conv_params, input_dims, filter_dims, output_dims, lhs_offset, bias_data);
-  capture_end_counters_and_log("arm_depthwise_convolve_weight_sum", toc_us(t0), rc);
-  log_kernel("arm_depthwise_convolve_weight_sum", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_weight_sum(&shape, filter_dims->c, filter_dims->h * filter_dims->w, 8);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_convolve_weight_sum, &shape, false, rc,
+      __real_arm_depthwise_convolve_weight_sum(
+          vector_sum_buf, scratch_buf, rhs, dw_conv_params, input_dims, filter_dims, output_dims, lhs_offset,
+          bias_data));
   return rc;
 }
 
@@ -867,12 +2738,13 @@ arm_cmsis_nn_status __wrap_arm_depthwise_weight_sum_s4(
     const cmsis_nn_dims *filter_dims, const cmsis_nn_dims *output_dims, const int32_t lhs_offset,
     const int32_t *bias_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_depthwise_weight_sum_s4(
-      vector_sum_buf, weights_s4, input_dims, filter_dims, output_dims, lhs_offset, bias_data);
-  capture_end_counters_and_log("arm_depthwise_weight_sum_s4", toc_us(t0), rc);
-  log_kernel("arm_depthwise_weight_sum_s4", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_weight_sum(&shape, filter_dims->c, filter_dims->h * filter_dims->w, 4);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_depthwise_weight_sum_s4, &shape, false, rc,
+      __real_arm_depthwise_weight_sum_s4(
+          vector_sum_buf, weights_s4, input_dims, filter_dims, output_dims, lhs_offset, bias_data));
   return rc;
 }
 
@@ -891,14 +2763,15 @@ arm_cmsis_nn_status __wrap_arm_elementwise_add_s16(
     const int32_t out_shift, const int32_t out_activation_min, const int32_t out_activation_max,
     const int32_t block_size)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_elementwise_add_s16(
-      input_1_vect, input_2_vect, input_1_offset, input_1_mult, input_1_shift, input_2_offset, input_2_mult,
-      input_2_shift, left_shift, output, out_offset, out_mult, out_shift, out_activation_min, out_activation_max,
-      block_size);
-  capture_end_counters_and_log("arm_elementwise_add_s16", toc_us(t0), rc);
-  log_kernel("arm_elementwise_add_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_flat(&shape, block_size, 2, sizeof(int16_t), sizeof(int16_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_elementwise_add_s16, &shape, output == input_1_vect || output == input_2_vect, rc,
+      __real_arm_elementwise_add_s16(
+          input_1_vect, input_2_vect, input_1_offset, input_1_mult, input_1_shift, input_2_offset, input_2_mult,
+          input_2_shift, left_shift, output, out_offset, out_mult, out_shift, out_activation_min, out_activation_max,
+          block_size));
   return rc;
 }
 
@@ -915,14 +2788,15 @@ arm_cmsis_nn_status __wrap_arm_elementwise_add_s8(
     const int32_t left_shift, int8_t *output, const int32_t out_offset, const int32_t out_mult, const int32_t out_shift,
     const int32_t out_activation_min, const int32_t out_activation_max, const int32_t block_size)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_elementwise_add_s8(
-      input_1_vect, input_2_vect, input_1_offset, input_1_mult, input_1_shift, input_2_offset, input_2_mult,
-      input_2_shift, left_shift, output, out_offset, out_mult, out_shift, out_activation_min, out_activation_max,
-      block_size);
-  capture_end_counters_and_log("arm_elementwise_add_s8", toc_us(t0), rc);
-  log_kernel("arm_elementwise_add_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_flat(&shape, block_size, 2, sizeof(int8_t), sizeof(int8_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_elementwise_add_s8, &shape, output == input_1_vect || output == input_2_vect, rc,
+      __real_arm_elementwise_add_s8(
+          input_1_vect, input_2_vect, input_1_offset, input_1_mult, input_1_shift, input_2_offset, input_2_mult,
+          input_2_shift, left_shift, output, out_offset, out_mult, out_shift, out_activation_min, out_activation_max,
+          block_size));
   return rc;
 }
 
@@ -939,13 +2813,14 @@ arm_cmsis_nn_status __wrap_arm_elementwise_mul_s16(
     const int32_t out_shift, const int32_t out_activation_min, const int32_t out_activation_max,
     const int32_t block_size)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_elementwise_mul_s16(
-      input_1_vect, input_2_vect, input_1_offset, input_2_offset, output, out_offset, out_mult, out_shift,
-      out_activation_min, out_activation_max, block_size);
-  capture_end_counters_and_log("arm_elementwise_mul_s16", toc_us(t0), rc);
-  log_kernel("arm_elementwise_mul_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_flat(&shape, block_size, 2, sizeof(int16_t), sizeof(int16_t), 1);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_elementwise_mul_s16, &shape, output == input_1_vect || output == input_2_vect, rc,
+      __real_arm_elementwise_mul_s16(
+          input_1_vect, input_2_vect, input_1_offset, input_2_offset, output, out_offset, out_mult, out_shift,
+          out_activation_min, out_activation_max, block_size));
   return rc;
 }
 
@@ -960,13 +2835,14 @@ arm_cmsis_nn_status __wrap_arm_elementwise_mul_s8(
     int8_t *output, const int32_t out_offset, const int32_t out_mult, const int32_t out_shift,
     const int32_t out_activation_min, const int32_t out_activation_max, const int32_t block_size)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_elementwise_mul_s8(
-      input_1_vect, input_2_vect, input_1_offset, input_2_offset, output, out_offset, out_mult, out_shift,
-      out_activation_min, out_activation_max, block_size);
-  capture_end_counters_and_log("arm_elementwise_mul_s8", toc_us(t0), rc);
-  log_kernel("arm_elementwise_mul_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_flat(&shape, block_size, 2, sizeof(int8_t), sizeof(int8_t), 1);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_elementwise_mul_s8, &shape, output == input_1_vect || output == input_2_vect, rc,
+      __real_arm_elementwise_mul_s8(
+          input_1_vect, input_2_vect, input_1_offset, input_2_offset, output, out_offset, out_mult, out_shift,
+          out_activation_min, out_activation_max, block_size));
   return rc;
 }
 
@@ -983,13 +2859,14 @@ arm_cmsis_nn_status __wrap_arm_fully_connected_per_channel_s8(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_fully_connected_per_channel_s8(
-      ctx, fc_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims, bias_data, output_dims,
-      output_data);
-  capture_end_counters_and_log("arm_fully_connected_per_channel_s8", toc_us(t0), rc);
-  log_kernel("arm_fully_connected_per_channel_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_fc(&shape, input_dims, filter_dims, output_dims, sizeof(int8_t), 8, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_fully_connected_per_channel_s8, &shape, output_data == input_data, rc,
+      __real_arm_fully_connected_per_channel_s8(
+          ctx, fc_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims, bias_data,
+          output_dims, output_data));
   return rc;
 }
 
@@ -1006,16 +2883,56 @@ arm_cmsis_nn_status __wrap_arm_fully_connected_s16(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int64_t *bias_data, const cmsis_nn_dims *output_dims, int16_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_fully_connected_s16(
-      ctx, fc_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims, bias_data, output_dims,
-      output_data);
-  capture_end_counters_and_log("arm_fully_connected_s16", toc_us(t0), rc);
-  log_kernel("arm_fully_connected_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_fc(&shape, input_dims, filter_dims, output_dims, sizeof(int16_t), 8, sizeof(int64_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_fully_connected_s16, &shape, output_data == input_data, rc,
+      __real_arm_fully_connected_s16(
+          ctx, fc_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims, bias_data,
+          output_dims, output_data));
   return rc;
 }
 
+// arm_fully_connected_s16_get_buffer_size
+int32_t __real_arm_fully_connected_s16_get_buffer_size(const cmsis_nn_dims *filter_dims);
+
+int32_t __wrap_arm_fully_connected_s16_get_buffer_size(const cmsis_nn_dims *filter_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_fully_connected_s16_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_fully_connected_s16_get_buffer_size(filter_dims), ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_fully_connected_s16_get_buffer_size_dsp
+int32_t __real_arm_fully_connected_s16_get_buffer_size_dsp(const cmsis_nn_dims *filter_dims);
+
+int32_t __wrap_arm_fully_connected_s16_get_buffer_size_dsp(const cmsis_nn_dims *filter_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_fully_connected_s16_get_buffer_size_dsp, NULL, false, rc,
+      (ret = __real_arm_fully_connected_s16_get_buffer_size_dsp(filter_dims), ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_fully_connected_s16_get_buffer_size_mve
+int32_t __real_arm_fully_connected_s16_get_buffer_size_mve(const cmsis_nn_dims *filter_dims);
+
+int32_t __wrap_arm_fully_connected_s16_get_buffer_size_mve(const cmsis_nn_dims *filter_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_fully_connected_s16_get_buffer_size_mve, NULL, false, rc,
+      (ret = __real_arm_fully_connected_s16_get_buffer_size_mve(filter_dims), ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
 // arm_fully_connected_s4
 arm_cmsis_nn_status __real_arm_fully_connected_s4(
     const cmsis_nn_context *ctx, const cmsis_nn_fc_params *fc_params,
@@ -1029,13 +2946,14 @@ arm_cmsis_nn_status __wrap_arm_fully_connected_s4(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_fully_connected_s4(
-      ctx, fc_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims, bias_data, output_dims,
-      output_data);
-  capture_end_counters_and_log("arm_fully_connected_s4", toc_us(t0), rc);
-  log_kernel("arm_fully_connected_s4", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_fc(&shape, input_dims, filter_dims, output_dims, sizeof(int8_t), 4, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_fully_connected_s4, &shape, output_data == input_data, rc,
+      __real_arm_fully_connected_s4(
+          ctx, fc_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims, bias_data,
+          output_dims, output_data));
   return rc;
 }
 
@@ -1052,16 +2970,56 @@ arm_cmsis_nn_status __wrap_arm_fully_connected_s8(
     const cmsis_nn_dims *filter_dims, const int8_t *filter_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_fully_connected_s8(
-      ctx, fc_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims, bias_data, output_dims,
-      output_data);
-  capture_end_counters_and_log("arm_fully_connected_s8", toc_us(t0), rc);
-  log_kernel("arm_fully_connected_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_fc(&shape, input_dims, filter_dims, output_dims, sizeof(int8_t), 8, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_fully_connected_s8, &shape, output_data == input_data, rc,
+      __real_arm_fully_connected_s8(
+          ctx, fc_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims, bias_data,
+          output_dims, output_data));
   return rc;
 }
 
+// arm_fully_connected_s8_get_buffer_size
+int32_t __real_arm_fully_connected_s8_get_buffer_size(const cmsis_nn_dims *filter_dims);
+
+int32_t __wrap_arm_fully_connected_s8_get_buffer_size(const cmsis_nn_dims *filter_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_fully_connected_s8_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_fully_connected_s8_get_buffer_size(filter_dims), ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_fully_connected_s8_get_buffer_size_dsp
+int32_t __real_arm_fully_connected_s8_get_buffer_size_dsp(const cmsis_nn_dims *filter_dims);
+
+int32_t __wrap_arm_fully_connected_s8_get_buffer_size_dsp(const cmsis_nn_dims *filter_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_fully_connected_s8_get_buffer_size_dsp, NULL, false, rc,
+      (ret = __real_arm_fully_connected_s8_get_buffer_size_dsp(filter_dims), ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_fully_connected_s8_get_buffer_size_mve
+int32_t __real_arm_fully_connected_s8_get_buffer_size_mve(const cmsis_nn_dims *filter_dims);
+
+int32_t __wrap_arm_fully_connected_s8_get_buffer_size_mve(const cmsis_nn_dims *filter_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_fully_connected_s8_get_buffer_size_mve, NULL, false, rc,
+      (ret = __real_arm_fully_connected_s8_get_buffer_size_mve(filter_dims), ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
 // arm_fully_connected_wrapper_s8
 arm_cmsis_nn_status __real_arm_fully_connected_wrapper_s8(
     const cmsis_nn_context *ctx, const cmsis_nn_fc_params *fc_params, const cmsis_nn_quant_params *quant_params,
@@ -1075,13 +3033,14 @@ arm_cmsis_nn_status __wrap_arm_fully_connected_wrapper_s8(
     const int8_t *filter_data, const cmsis_nn_dims *bias_dims, const int32_t *bias_data,
     const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_fully_connected_wrapper_s8(
-      ctx, fc_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims, bias_data, output_dims,
-      output_data);
-  capture_end_counters_and_log("arm_fully_connected_wrapper_s8", toc_us(t0), rc);
-  log_kernel("arm_fully_connected_wrapper_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_fc(&shape, input_dims, filter_dims, output_dims, sizeof(int8_t), 8, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_fully_connected_wrapper_s8, &shape, output_data == input_data, rc,
+      __real_arm_fully_connected_wrapper_s8(
+          ctx, fc_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims, bias_data,
+          output_dims, output_data));
   return rc;
 }
 
@@ -1096,13 +3055,14 @@ arm_cmsis_nn_status __wrap_arm_hard_swish_compat_s16(
     const int32_t output_multiplier_exp, const int32_t relu_multiplier_fp, const int32_t relu_multiplier_exp,
     int16_t *output, const int32_t output_size)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_hard_swish_compat_s16(
-      input, input_offset, output_offset, output_multiplier_fp, output_multiplier_exp, relu_multiplier_fp,
-      relu_multiplier_exp, output, output_size);
-  capture_end_counters_and_log("arm_hard_swish_compat_s16", toc_us(t0), rc);
-  log_kernel("arm_hard_swish_compat_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_flat(&shape, output_size, 1, sizeof(int16_t), sizeof(int16_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_hard_swish_compat_s16, &shape, output == input, rc,
+      __real_arm_hard_swish_compat_s16(
+          input, input_offset, output_offset, output_multiplier_fp, output_multiplier_exp, relu_multiplier_fp,
+          relu_multiplier_exp, output, output_size));
   return rc;
 }
 
@@ -1117,13 +3077,14 @@ arm_cmsis_nn_status __wrap_arm_hard_swish_compat_s8(
     const int32_t output_multiplier_exp, const int32_t relu_multiplier_fp, const int32_t relu_multiplier_exp,
     int8_t *output, const int32_t output_size)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_hard_swish_compat_s8(
-      input, input_offset, output_offset, output_multiplier_fp, output_multiplier_exp, relu_multiplier_fp,
-      relu_multiplier_exp, output, output_size);
-  capture_end_counters_and_log("arm_hard_swish_compat_s8", toc_us(t0), rc);
-  log_kernel("arm_hard_swish_compat_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_flat(&shape, output_size, 1, sizeof(int8_t), sizeof(int8_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_hard_swish_compat_s8, &shape, output == input, rc,
+      __real_arm_hard_swish_compat_s8(
+          input, input_offset, output_offset, output_multiplier_fp, output_multiplier_exp, relu_multiplier_fp,
+          relu_multiplier_exp, output, output_size));
   return rc;
 }
 
@@ -1138,12 +3099,13 @@ arm_cmsis_nn_status __wrap_arm_hard_swish_precise_s16(
     const int32_t output_shift, const int32_t relu_q3, const int32_t relu_q6, int16_t *output,
     const int32_t output_size)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_hard_swish_precise_s16(
-      input, input_offset, output_offset, output_multiplier, output_shift, relu_q3, relu_q6, output, output_size);
-  capture_end_counters_and_log("arm_hard_swish_precise_s16", toc_us(t0), rc);
-  log_kernel("arm_hard_swish_precise_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_flat(&shape, output_size, 1, sizeof(int16_t), sizeof(int16_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_hard_swish_precise_s16, &shape, output == input, rc,
+      __real_arm_hard_swish_precise_s16(
+          input, input_offset, output_offset, output_multiplier, output_shift, relu_q3, relu_q6, output, output_size));
   return rc;
 }
 
@@ -1157,12 +3119,13 @@ arm_cmsis_nn_status __wrap_arm_hard_swish_precise_s8(
     const int8_t *input, const int32_t input_offset, const int32_t output_offset, const int32_t output_multiplier,
     const int32_t output_shift, const int32_t relu_q3, const int32_t relu_q6, int8_t *output, const int32_t output_size)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_hard_swish_precise_s8(
-      input, input_offset, output_offset, output_multiplier, output_shift, relu_q3, relu_q6, output, output_size);
-  capture_end_counters_and_log("arm_hard_swish_precise_s8", toc_us(t0), rc);
-  log_kernel("arm_hard_swish_precise_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_flat(&shape, output_size, 1, sizeof(int8_t), sizeof(int8_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_hard_swish_precise_s8, &shape, output == input, rc,
+      __real_arm_hard_swish_precise_s8(
+          input, input_offset, output_offset, output_multiplier, output_shift, relu_q3, relu_q6, output, output_size));
   return rc;
 }
 
@@ -1177,13 +3140,14 @@ arm_cmsis_nn_status __wrap_arm_leaky_relu_s8(
     const int32_t output_shift_alpha, const int32_t output_multiplier_identity, const int32_t output_shift_identity,
     int8_t *output, const int32_t output_size)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_leaky_relu_s8(
-      input, input_offset, output_offset, output_multiplier_alpha, output_shift_alpha, output_multiplier_identity,
-      output_shift_identity, output, output_size);
-  capture_end_counters_and_log("arm_leaky_relu_s8", toc_us(t0), rc);
-  log_kernel("arm_leaky_relu_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_flat(&shape, output_size, 1, sizeof(int8_t), sizeof(int8_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_leaky_relu_s8, &shape, output == input, rc,
+      __real_arm_leaky_relu_s8(
+          input, input_offset, output_offset, output_multiplier_alpha, output_shift_alpha, output_multiplier_identity,
+          output_shift_identity, output, output_size));
   return rc;
 }
 
@@ -1194,11 +3158,10 @@ arm_cmsis_nn_status __real_arm_lstm_unidirectional_s16(
 arm_cmsis_nn_status __wrap_arm_lstm_unidirectional_s16(
     const int16_t *input, int16_t *output, const cmsis_nn_lstm_params *params, cmsis_nn_lstm_context *buffers)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_lstm_unidirectional_s16(input, output, params, buffers);
-  capture_end_counters_and_log("arm_lstm_unidirectional_s16", toc_us(t0), rc);
-  log_kernel("arm_lstm_unidirectional_s16", toc_us(t0));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_lstm_unidirectional_s16, NULL, output == input, rc,
+      __real_arm_lstm_unidirectional_s16(input, output, params, buffers));
   return rc;
 }
 
@@ -1209,11 +3172,10 @@ arm_cmsis_nn_status __real_arm_lstm_unidirectional_s8(
 arm_cmsis_nn_status __wrap_arm_lstm_unidirectional_s8(
     const int8_t *input, int8_t *output, const cmsis_nn_lstm_params *params, cmsis_nn_lstm_context *buffers)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_lstm_unidirectional_s8(input, output, params, buffers);
-  capture_end_counters_and_log("arm_lstm_unidirectional_s8", toc_us(t0), rc);
-  log_kernel("arm_lstm_unidirectional_s8", toc_us(t0));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_lstm_unidirectional_s8, NULL, output == input, rc,
+      __real_arm_lstm_unidirectional_s8(input, output, params, buffers));
   return rc;
 }
 
@@ -1226,11 +3188,12 @@ arm_cmsis_nn_status __wrap_arm_max_pool_s16(
     const cmsis_nn_context *ctx, const cmsis_nn_pool_params *pool_params, const cmsis_nn_dims *input_dims,
     const int16_t *src, const cmsis_nn_dims *filter_dims, const cmsis_nn_dims *output_dims, int16_t *dst)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_max_pool_s16(ctx, pool_params, input_dims, src, filter_dims, output_dims, dst);
-  capture_end_counters_and_log("arm_max_pool_s16", toc_us(t0), rc);
-  log_kernel("arm_max_pool_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_pool(&shape, pool_params, input_dims, filter_dims, output_dims, sizeof(int16_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_max_pool_s16, &shape, false, rc,
+      __real_arm_max_pool_s16(ctx, pool_params, input_dims, src, filter_dims, output_dims, dst));
   return rc;
 }
 
@@ -1243,10 +3206,12 @@ arm_cmsis_nn_status __wrap_arm_max_pool_s8(
     const cmsis_nn_context *ctx, const cmsis_nn_pool_params *pool_params, const cmsis_nn_dims *input_dims,
     const int8_t *input_data, const cmsis_nn_dims *filter_dims, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-  arm_cmsis_nn_status rc =
-      __real_arm_max_pool_s8(ctx, pool_params, input_dims, input_data, filter_dims, output_dims, output_data);
-  log_kernel("arm_max_pool_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_pool(&shape, pool_params, input_dims, filter_dims, output_dims, sizeof(int8_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_max_pool_s8, &shape, output_data == input_data, rc,
+      __real_arm_max_pool_s8(ctx, pool_params, input_dims, input_data, filter_dims, output_dims, output_data));
   return rc;
 }
 
@@ -1261,10 +3226,12 @@ arm_cmsis_nn_status __wrap_arm_maximum_s16(
     const int16_t *input_2_data, const cmsis_nn_dims *input_2_dims, int16_t *output_data,
     const cmsis_nn_dims *output_dims)
 {
-  uint32_t t0 = tic_us();
-  arm_cmsis_nn_status rc =
-      __real_arm_maximum_s16(ctx, input_1_data, input_1_dims, input_2_data, input_2_dims, output_data, output_dims);
-  log_kernel("arm_maximum_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_binary(&shape, input_1_dims, input_2_dims, output_dims, sizeof(int16_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_maximum_s16, &shape, output_data == input_1_data || output_data == input_2_data, rc,
+      __real_arm_maximum_s16(ctx, input_1_data, input_1_dims, input_2_data, input_2_dims, output_data, output_dims));
   return rc;
 }
 
@@ -1279,10 +3246,12 @@ arm_cmsis_nn_status __wrap_arm_maximum_s8(
     const int8_t *input_2_data, const cmsis_nn_dims *input_2_dims, int8_t *output_data,
     const cmsis_nn_dims *output_dims)
 {
-  uint32_t t0 = tic_us();
-  arm_cmsis_nn_status rc =
-      __real_arm_maximum_s8(ctx, input_1_data, input_1_dims, input_2_data, input_2_dims, output_data, output_dims);
-  log_kernel("arm_maximum_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_binary(&shape, input_1_dims, input_2_dims, output_dims, sizeof(int8_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_maximum_s8, &shape, output_data == input_1_data || output_data == input_2_data, rc,
+      __real_arm_maximum_s8(ctx, input_1_data, input_1_dims, input_2_data, input_2_dims, output_data, output_dims));
   return rc;
 }
 
@@ -1297,12 +3266,13 @@ arm_cmsis_nn_status __wrap_arm_mean_s16(
     const cmsis_nn_dims *axis_dims, int16_t *output_data, const cmsis_nn_dims *output_dims, const int32_t out_offset,
     const int32_t out_mult, const int32_t out_shift)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_mean_s16(
-      input_data, input_dims, input_offset, axis_dims, output_data, output_dims, out_offset, out_mult, out_shift);
-  capture_end_counters_and_log("arm_mean_s16", toc_us(t0), rc);
-  log_kernel("arm_mean_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_unary(&shape, input_dims, output_dims, sizeof(int16_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_mean_s16, &shape, output_data == input_data, rc,
+      __real_arm_mean_s16(
+          input_data, input_dims, input_offset, axis_dims, output_data, output_dims, out_offset, out_mult, out_shift));
   return rc;
 }
 
@@ -1317,12 +3287,13 @@ arm_cmsis_nn_status __wrap_arm_mean_s8(
     const cmsis_nn_dims *axis_dims, int8_t *output_data, const cmsis_nn_dims *output_dims, const int32_t out_offset,
     const int32_t out_mult, const int32_t out_shift)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_mean_s8(
-      input_data, input_dims, input_offset, axis_dims, output_data, output_dims, out_offset, out_mult, out_shift);
-  capture_end_counters_and_log("arm_mean_s8", toc_us(t0), rc);
-  log_kernel("arm_mean_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_unary(&shape, input_dims, output_dims, sizeof(int8_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_mean_s8, &shape, output_data == input_data, rc,
+      __real_arm_mean_s8(
+          input_data, input_dims, input_offset, axis_dims, output_data, output_dims, out_offset, out_mult, out_shift));
   return rc;
 }
 
@@ -1337,10 +3308,12 @@ arm_cmsis_nn_status __wrap_arm_minimum_s16(
     const int16_t *input_2_data, const cmsis_nn_dims *input_2_dims, int16_t *output_data,
     const cmsis_nn_dims *output_dims)
 {
-  uint32_t t0 = tic_us();
-  arm_cmsis_nn_status rc =
-      __real_arm_minimum_s16(ctx, input_1_data, input_1_dims, input_2_data, input_2_dims, output_data, output_dims);
-  log_kernel("arm_minimum_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_binary(&shape, input_1_dims, input_2_dims, output_dims, sizeof(int16_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_minimum_s16, &shape, output_data == input_1_data || output_data == input_2_data, rc,
+      __real_arm_minimum_s16(ctx, input_1_data, input_1_dims, input_2_data, input_2_dims, output_data, output_dims));
   return rc;
 }
 
@@ -1355,10 +3328,12 @@ arm_cmsis_nn_status __wrap_arm_minimum_s8(
     const int8_t *input_2_data, const cmsis_nn_dims *input_2_dims, int8_t *output_data,
     const cmsis_nn_dims *output_dims)
 {
-  uint32_t t0 = tic_us();
-  arm_cmsis_nn_status rc =
-      __real_arm_minimum_s8(ctx, input_1_data, input_1_dims, input_2_data, input_2_dims, output_data, output_dims);
-  log_kernel("arm_minimum_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_binary(&shape, input_1_dims, input_2_dims, output_dims, sizeof(int8_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_minimum_s8, &shape, output_data == input_1_data || output_data == input_2_data, rc,
+      __real_arm_minimum_s8(ctx, input_1_data, input_1_dims, input_2_data, input_2_dims, output_data, output_dims));
   return rc;
 }
 
@@ -1375,13 +3350,14 @@ arm_cmsis_nn_status __wrap_arm_mul_s16(
     const cmsis_nn_dims *output_dims, const int32_t out_offset, const int32_t out_mult, const int32_t out_shift,
     const int32_t out_activation_min, const int32_t out_activation_max)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_mul_s16(
-      input1_data, input1_dims, input2_data, input2_dims, input1_offset, input2_offset, output_data, output_dims,
-      out_offset, out_mult, out_shift, out_activation_min, out_activation_max);
-  capture_end_counters_and_log("arm_mul_s16", toc_us(t0), rc);
-  log_kernel("arm_mul_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_binary(&shape, input1_dims, input2_dims, output_dims, sizeof(int16_t), 1);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_mul_s16, &shape, output_data == input1_data || output_data == input2_data, rc,
+      __real_arm_mul_s16(
+          input1_data, input1_dims, input2_data, input2_dims, input1_offset, input2_offset, output_data, output_dims,
+          out_offset, out_mult, out_shift, out_activation_min, out_activation_max));
   return rc;
 }
 
@@ -1398,13 +3374,14 @@ arm_cmsis_nn_status __wrap_arm_mul_s8(
     const cmsis_nn_dims *output_dims, const int32_t out_offset, const int32_t out_mult, const int32_t out_shift,
     const int32_t out_activation_min, const int32_t out_activation_max)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_mul_s8(
-      input1_data, input1_dims, input2_data, input2_dims, input1_offset, input2_offset, output_data, output_dims,
-      out_offset, out_mult, out_shift, out_activation_min, out_activation_max);
-  capture_end_counters_and_log("arm_mul_s8", toc_us(t0), rc);
-  log_kernel("arm_mul_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_binary(&shape, input1_dims, input2_dims, output_dims, sizeof(int8_t), 1);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_mul_s8, &shape, output_data == input1_data || output_data == input2_data, rc,
+      __real_arm_mul_s8(
+          input1_data, input1_dims, input2_data, input2_dims, input1_offset, input2_offset, output_data, output_dims,
+          out_offset, out_mult, out_shift, out_activation_min, out_activation_max));
   return rc;
 }
 
@@ -1417,11 +3394,12 @@ arm_cmsis_nn_status __wrap_arm_pad_s16(
     const int16_t *input, int16_t *output, const int16_t pad_value, const cmsis_nn_dims *input_size,
     const cmsis_nn_dims *pre_pad, const cmsis_nn_dims *post_pad)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_pad_s16(input, output, pad_value, input_size, pre_pad, post_pad);
-  capture_end_counters_and_log("arm_pad_s16", toc_us(t0), rc);
-  log_kernel("arm_pad_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_pad(&shape, input_size, pre_pad, post_pad, sizeof(int16_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_pad_s16, &shape, output == input, rc,
+      __real_arm_pad_s16(input, output, pad_value, input_size, pre_pad, post_pad));
   return rc;
 }
 
@@ -1434,11 +3412,12 @@ arm_cmsis_nn_status __wrap_arm_pad_s8(
     const int8_t *input, int8_t *output, const int8_t pad_value, const cmsis_nn_dims *input_size,
     const cmsis_nn_dims *pre_pad, const cmsis_nn_dims *post_pad)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_pad_s8(input, output, pad_value, input_size, pre_pad, post_pad);
-  capture_end_counters_and_log("arm_pad_s8", toc_us(t0), rc);
-  log_kernel("arm_pad_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_pad(&shape, input_size, pre_pad, post_pad, sizeof(int8_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_pad_s8, &shape, output == input, rc,
+      __real_arm_pad_s8(input, output, pad_value, input_size, pre_pad, post_pad));
   return rc;
 }
 
@@ -1449,9 +3428,11 @@ __real_arm_quantize_f32_s16(const float *input, int16_t *output, int32_t size, i
 arm_cmsis_nn_status
 __wrap_arm_quantize_f32_s16(const float *input, int16_t *output, int32_t size, int32_t zero_point, float scale)
 {
-  uint32_t t0 = tic_us();
-  arm_cmsis_nn_status rc = __real_arm_quantize_f32_s16(input, output, size, zero_point, scale);
-  log_kernel("arm_quantize_f32_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_flat(&shape, size, 1, sizeof(float), sizeof(int16_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_quantize_f32_s16, &shape, false, rc, __real_arm_quantize_f32_s16(input, output, size, zero_point, scale));
   return rc;
 }
 
@@ -1462,9 +3443,11 @@ __real_arm_quantize_f32_s8(const float *input, int8_t *output, int32_t size, int
 arm_cmsis_nn_status
 __wrap_arm_quantize_f32_s8(const float *input, int8_t *output, int32_t size, int32_t zero_point, float scale)
 {
-  uint32_t t0 = tic_us();
-  arm_cmsis_nn_status rc = __real_arm_quantize_f32_s8(input, output, size, zero_point, scale);
-  log_kernel("arm_quantize_f32_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_flat(&shape, size, 1, sizeof(float), sizeof(int8_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_quantize_f32_s8, &shape, false, rc, __real_arm_quantize_f32_s8(input, output, size, zero_point, scale));
   return rc;
 }
 
@@ -1477,11 +3460,12 @@ arm_cmsis_nn_status __wrap_arm_reduce_max_s16(
     const int16_t *input_data, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *axis_dims, int16_t *output_data,
     const cmsis_nn_dims *output_dims)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_reduce_max_s16(input_data, input_dims, axis_dims, output_data, output_dims);
-  capture_end_counters_and_log("arm_reduce_max_s16", toc_us(t0), rc);
-  log_kernel("arm_reduce_max_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_unary(&shape, input_dims, output_dims, sizeof(int16_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_reduce_max_s16, &shape, output_data == input_data, rc,
+      __real_arm_reduce_max_s16(input_data, input_dims, axis_dims, output_data, output_dims));
   return rc;
 }
 
@@ -1494,11 +3478,12 @@ arm_cmsis_nn_status __wrap_arm_reduce_max_s8(
     const int8_t *input_data, const cmsis_nn_dims *input_dims, const cmsis_nn_dims *axis_dims, int8_t *output_data,
     const cmsis_nn_dims *output_dims)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_reduce_max_s8(input_data, input_dims, axis_dims, output_data, output_dims);
-  capture_end_counters_and_log("arm_reduce_max_s8", toc_us(t0), rc);
-  log_kernel("arm_reduce_max_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_unary(&shape, input_dims, output_dims, sizeof(int8_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_reduce_max_s8, &shape, output_data == input_data, rc,
+      __real_arm_reduce_max_s8(input_data, input_dims, axis_dims, output_data, output_dims));
   return rc;
 }
 
@@ -1511,10 +3496,12 @@ arm_cmsis_nn_status __wrap_arm_relu_s16(
     const int16_t *input, const int32_t input_offset, const int32_t output_offset, const int32_t output_multiplier,
     const int32_t output_shift, int16_t *output, const int32_t output_size)
 {
-  uint32_t t0 = tic_us();
-  arm_cmsis_nn_status rc =
-      __real_arm_relu_s16(input, input_offset, output_offset, output_multiplier, output_shift, output, output_size);
-  log_kernel("arm_relu_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_flat(&shape, output_size, 1, sizeof(int16_t), sizeof(int16_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_relu_s16, &shape, output == input, rc,
+      __real_arm_relu_s16(input, input_offset, output_offset, output_multiplier, output_shift, output, output_size));
   return rc;
 }
 
@@ -1527,10 +3514,12 @@ arm_cmsis_nn_status __wrap_arm_relu_s8(
     const int8_t *input, const int32_t input_offset, const int32_t output_offset, const int32_t output_multiplier,
     const int32_t output_shift, int8_t *output, const int32_t output_size)
 {
-  uint32_t t0 = tic_us();
-  arm_cmsis_nn_status rc =
-      __real_arm_relu_s8(input, input_offset, output_offset, output_multiplier, output_shift, output, output_size);
-  log_kernel("arm_relu_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_flat(&shape, output_size, 1, sizeof(int8_t), sizeof(int8_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_relu_s8, &shape, output == input, rc,
+      __real_arm_relu_s8(input, input_offset, output_offset, output_multiplier, output_shift, output, output_size));
   return rc;
 }
 
@@ -1543,12 +3532,13 @@ arm_cmsis_nn_status __wrap_arm_requantize_s16_s16(
     const int16_t *input, int16_t *output, int32_t size, int32_t effective_scale_multiplier,
     int32_t effective_scale_shift, int32_t input_zeropoint, int32_t output_zeropoint)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_requantize_s16_s16(
-      input, output, size, effective_scale_multiplier, effective_scale_shift, input_zeropoint, output_zeropoint);
-  capture_end_counters_and_log("arm_requantize_s16_s16", toc_us(t0), rc);
-  log_kernel("arm_requantize_s16_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_flat(&shape, size, 1, sizeof(int16_t), sizeof(int16_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_requantize_s16_s16, &shape, output == input, rc,
+      __real_arm_requantize_s16_s16(
+          input, output, size, effective_scale_multiplier, effective_scale_shift, input_zeropoint, output_zeropoint));
   return rc;
 }
 
@@ -1561,12 +3551,13 @@ arm_cmsis_nn_status __wrap_arm_requantize_s8_s8(
     const int8_t *input, int8_t *output, int32_t size, int32_t effective_scale_multiplier,
     int32_t effective_scale_shift, int32_t input_zeropoint, int32_t output_zeropoint)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_requantize_s8_s8(
-      input, output, size, effective_scale_multiplier, effective_scale_shift, input_zeropoint, output_zeropoint);
-  capture_end_counters_and_log("arm_requantize_s8_s8", toc_us(t0), rc);
-  log_kernel("arm_requantize_s8_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_flat(&shape, size, 1, sizeof(int8_t), sizeof(int8_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_requantize_s8_s8, &shape, output == input, rc,
+      __real_arm_requantize_s8_s8(
+          input, output, size, effective_scale_multiplier, effective_scale_shift, input_zeropoint, output_zeropoint));
   return rc;
 }
 
@@ -1579,11 +3570,12 @@ arm_cmsis_nn_status __wrap_arm_softmax_s16(
     const int16_t *input, const int32_t num_rows, const int32_t row_size, const int32_t mult, const int32_t shift,
     const cmsis_nn_softmax_lut_s16 *softmax_params, int16_t *output)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_softmax_s16(input, num_rows, row_size, mult, shift, softmax_params, output);
-  capture_end_counters_and_log("arm_softmax_s16", toc_us(t0), rc);
-  log_kernel("arm_softmax_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_flat(&shape, num_rows * row_size, 1, sizeof(int16_t), sizeof(int16_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_softmax_s16, &shape, output == input, rc,
+      __real_arm_softmax_s16(input, num_rows, row_size, mult, shift, softmax_params, output));
   return rc;
 }
 
@@ -1592,34 +3584,36 @@ arm_cmsis_nn_status __real_arm_softmax_s8(
     const int8_t *input, const int32_t num_rows, const int32_t row_size, const int32_t mult, const int32_t shift,
     const int32_t diff_min, int8_t *output);
 
-    arm_cmsis_nn_status __wrap_arm_softmax_s8(
+arm_cmsis_nn_status __wrap_arm_softmax_s8(
     const int8_t *input, const int32_t num_rows, const int32_t row_size, const int32_t mult, const int32_t shift,
     const int32_t diff_min, int8_t *output)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-    arm_cmsis_nn_status rc = __real_arm_softmax_s8(input, num_rows, row_size, mult, shift, diff_min, output);
-  capture_end_counters_and_log("arm_softmax_s8", toc_us(t0), rc);
-  log_kernel("arm_softmax_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_flat(&shape, num_rows * row_size, 1, sizeof(int8_t), sizeof(int8_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_softmax_s8, &shape, output == input, rc,
+      __real_arm_softmax_s8(input, num_rows, row_size, mult, shift, diff_min, output));
   return rc;
-  }
+}
 
 // arm_softmax_s8_s16
 arm_cmsis_nn_status __real_arm_softmax_s8_s16(
     const int8_t *input, const int32_t num_rows, const int32_t row_size, const int32_t mult, const int32_t shift,
     const int32_t diff_min, int16_t *output);
 
-    arm_cmsis_nn_status __wrap_arm_softmax_s8_s16(
+arm_cmsis_nn_status __wrap_arm_softmax_s8_s16(
     const int8_t *input, const int32_t num_rows, const int32_t row_size, const int32_t mult, const int32_t shift,
     const int32_t diff_min, int16_t *output)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-    arm_cmsis_nn_status rc =  __real_arm_softmax_s8_s16(input, num_rows, row_size, mult, shift, diff_min, output);
-  capture_end_counters_and_log("arm_softmax_s8_s16", toc_us(t0), rc);
-  log_kernel("arm_softmax_s8_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_flat(&shape, num_rows * row_size, 1, sizeof(int8_t), sizeof(int16_t), 0);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_softmax_s8_s16, &shape, false, rc,
+      __real_arm_softmax_s8_s16(input, num_rows, row_size, mult, shift, diff_min, output));
   return rc;
-  }
+}
 
 // arm_strided_slice_s8
 arm_cmsis_nn_status __real_arm_strided_slice_s8(
@@ -1632,10 +3626,12 @@ arm_cmsis_nn_status __wrap_arm_strided_slice_s8(
     const cmsis_nn_dims *const begin_dims, const cmsis_nn_dims *const stride_dims,
     const cmsis_nn_dims *const output_dims)
 {
-  uint32_t t0 = tic_us();
-  arm_cmsis_nn_status rc =
-      __real_arm_strided_slice_s8(input_data, output_data, input_dims, begin_dims, stride_dims, output_dims);
-  log_kernel("arm_strided_slice_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_slice(&shape, input_dims, output_dims);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_strided_slice_s8, &shape, output_data == input_data, rc,
+      __real_arm_strided_slice_s8(input_data, output_data, input_dims, begin_dims, stride_dims, output_dims));
   return rc;
 }
 
@@ -1658,14 +3654,13 @@ arm_cmsis_nn_status __wrap_arm_svdf_s8(
     const cmsis_nn_dims *weights_time_dims, const int8_t *weights_time_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_svdf_s8(
-      ctx, input_ctx, output_ctx, svdf_params, input_quant_params, output_quant_params, input_dims, input_data,
-      state_dims, state_data, weights_feature_dims, weights_feature_data, weights_time_dims, weights_time_data,
-      bias_dims, bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_svdf_s8", toc_us(t0), rc);
-  log_kernel("arm_svdf_s8", toc_us(t0));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_svdf_s8, NULL, output_data == input_data, rc,
+      __real_arm_svdf_s8(
+          ctx, input_ctx, output_ctx, svdf_params, input_quant_params, output_quant_params, input_dims, input_data,
+          state_dims, state_data, weights_feature_dims, weights_feature_data, weights_time_dims, weights_time_data,
+          bias_dims, bias_data, output_dims, output_data));
   return rc;
 }
 
@@ -1688,14 +3683,13 @@ arm_cmsis_nn_status __wrap_arm_svdf_state_s16_s8(
     const cmsis_nn_dims *weights_time_dims, const int16_t *weights_time_data, const cmsis_nn_dims *bias_dims,
     const int32_t *bias_data, const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_svdf_state_s16_s8(
-      input_ctx, output_ctx, svdf_params, input_quant_params, output_quant_params, input_dims, input_data, state_dims,
-      state_data, weights_feature_dims, weights_feature_data, weights_time_dims, weights_time_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_svdf_state_s16_s8", toc_us(t0), rc);
-  log_kernel("arm_svdf_state_s16_s8", toc_us(t0));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_svdf_state_s16_s8, NULL, output_data == input_data, rc,
+      __real_arm_svdf_state_s16_s8(
+          input_ctx, output_ctx, svdf_params, input_quant_params, output_quant_params, input_dims, input_data,
+          state_dims, state_data, weights_feature_dims, weights_feature_data, weights_time_dims, weights_time_data,
+          bias_dims, bias_data, output_dims, output_data));
   return rc;
 }
 
@@ -1714,16 +3708,55 @@ arm_cmsis_nn_status __wrap_arm_transpose_conv_s8(
     const int8_t *filter_data, const cmsis_nn_dims *bias_dims, const int32_t *bias_data,
     const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_transpose_conv_s8(
-      ctx, output_ctx, transpose_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data, bias_dims,
-      bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_transpose_conv_s8", toc_us(t0), rc);
-  log_kernel("arm_transpose_conv_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_TRANSPOSE_CONV, input_dims, filter_dims, output_dims, &transpose_conv_params->stride,
+      &transpose_conv_params->padding, &transpose_conv_params->dilation, sizeof(int8_t), 8, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_transpose_conv_s8, &shape, output_data == input_data, rc,
+      __real_arm_transpose_conv_s8(
+          ctx, output_ctx, transpose_conv_params, quant_params, input_dims, input_data, filter_dims, filter_data,
+          bias_dims, bias_data, output_dims, output_data));
   return rc;
 }
 
+// arm_transpose_conv_s8_get_buffer_size
+int32_t __real_arm_transpose_conv_s8_get_buffer_size(
+    const cmsis_nn_transpose_conv_params *transpose_conv_params, const cmsis_nn_dims *input_dims,
+    const cmsis_nn_dims *filter_dims, const cmsis_nn_dims *out_dims);
+
+int32_t __wrap_arm_transpose_conv_s8_get_buffer_size(
+    const cmsis_nn_transpose_conv_params *transpose_conv_params, const cmsis_nn_dims *input_dims,
+    const cmsis_nn_dims *filter_dims, const cmsis_nn_dims *out_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_transpose_conv_s8_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_transpose_conv_s8_get_buffer_size(transpose_conv_params, input_dims, filter_dims, out_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_transpose_conv_s8_get_reverse_conv_buffer_size
+int32_t __real_arm_transpose_conv_s8_get_reverse_conv_buffer_size(
+    const cmsis_nn_transpose_conv_params *transpose_conv_params, const cmsis_nn_dims *input_dims,
+    const cmsis_nn_dims *filter_dims);
+
+int32_t __wrap_arm_transpose_conv_s8_get_reverse_conv_buffer_size(
+    const cmsis_nn_transpose_conv_params *transpose_conv_params, const cmsis_nn_dims *input_dims,
+    const cmsis_nn_dims *filter_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_transpose_conv_s8_get_reverse_conv_buffer_size, NULL, false, rc,
+      (ret = __real_arm_transpose_conv_s8_get_reverse_conv_buffer_size(transpose_conv_params, input_dims, filter_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
 // arm_transpose_conv_wrapper_s8
 arm_cmsis_nn_status __real_arm_transpose_conv_wrapper_s8(
     const cmsis_nn_context *ctx, const cmsis_nn_context *weight_sum_ctx, const cmsis_nn_context *output_ctx,
@@ -1739,16 +3772,133 @@ arm_cmsis_nn_status __wrap_arm_transpose_conv_wrapper_s8(
     const int8_t *filter_data, const cmsis_nn_dims *bias_dims, const int32_t *bias_data,
     const cmsis_nn_dims *output_dims, int8_t *output_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_transpose_conv_wrapper_s8(
-      ctx, weight_sum_ctx, output_ctx, transpose_conv_params, quant_params, input_dims, input_data, filter_dims,
-      filter_data, bias_dims, bias_data, output_dims, output_data);
-  capture_end_counters_and_log("arm_transpose_conv_wrapper_s8", toc_us(t0), rc);
-  log_kernel("arm_transpose_conv_wrapper_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_conv(
+      &shape, SHAPE_TRANSPOSE_CONV, input_dims, filter_dims, output_dims, &transpose_conv_params->stride,
+      &transpose_conv_params->padding, &transpose_conv_params->dilation, sizeof(int8_t), 8, sizeof(int32_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_transpose_conv_wrapper_s8, &shape, output_data == input_data, rc,
+      __real_arm_transpose_conv_wrapper_s8(
+          ctx, weight_sum_ctx, output_ctx, transpose_conv_params, quant_params, input_dims, input_data, filter_dims,
+          filter_data, bias_dims, bias_data, output_dims, output_data));
   return rc;
 }
 
+// arm_transpose_conv_wrapper_s8_get_buffer_size
+int32_t __real_arm_transpose_conv_wrapper_s8_get_buffer_size(
+    const cmsis_nn_transpose_conv_params *transpose_conv_params, const cmsis_nn_dims *input_dims,
+    const cmsis_nn_dims *filter_dims, const cmsis_nn_dims *out_dims);
+
+int32_t __wrap_arm_transpose_conv_wrapper_s8_get_buffer_size(
+    const cmsis_nn_transpose_conv_params *transpose_conv_params, const cmsis_nn_dims *input_dims,
+    const cmsis_nn_dims *filter_dims, const cmsis_nn_dims *out_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_transpose_conv_wrapper_s8_get_buffer_size, NULL, false, rc,
+      (ret = __real_arm_transpose_conv_wrapper_s8_get_buffer_size(
+          transpose_conv_params, input_dims, filter_dims, out_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_transpose_conv_wrapper_s8_get_buffer_size_dsp
+int32_t __real_arm_transpose_conv_wrapper_s8_get_buffer_size_dsp(
+    const cmsis_nn_transpose_conv_params *transpose_conv_params, const cmsis_nn_dims *input_dims,
+    const cmsis_nn_dims *filter_dims, const cmsis_nn_dims *out_dims);
+
+int32_t __wrap_arm_transpose_conv_wrapper_s8_get_buffer_size_dsp(
+    const cmsis_nn_transpose_conv_params *transpose_conv_params, const cmsis_nn_dims *input_dims,
+    const cmsis_nn_dims *filter_dims, const cmsis_nn_dims *out_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_transpose_conv_wrapper_s8_get_buffer_size_dsp, NULL, false, rc,
+      (ret = __real_arm_transpose_conv_wrapper_s8_get_buffer_size_dsp(
+          transpose_conv_params, input_dims, filter_dims, out_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_transpose_conv_wrapper_s8_get_buffer_size_mve
+int32_t __real_arm_transpose_conv_wrapper_s8_get_buffer_size_mve(
+    const cmsis_nn_transpose_conv_params *transpose_conv_params, const cmsis_nn_dims *input_dims,
+    const cmsis_nn_dims *filter_dims, const cmsis_nn_dims *out_dims);
+
+int32_t __wrap_arm_transpose_conv_wrapper_s8_get_buffer_size_mve(
+    const cmsis_nn_transpose_conv_params *transpose_conv_params, const cmsis_nn_dims *input_dims,
+    const cmsis_nn_dims *filter_dims, const cmsis_nn_dims *out_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_transpose_conv_wrapper_s8_get_buffer_size_mve, NULL, false, rc,
+      (ret = __real_arm_transpose_conv_wrapper_s8_get_buffer_size_mve(
+          transpose_conv_params, input_dims, filter_dims, out_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size
+int32_t __real_arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size(
+    const cmsis_nn_transpose_conv_params *transpose_conv_params, const cmsis_nn_dims *input_dims,
+    const cmsis_nn_dims *filter_dims);
+
+int32_t __wrap_arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size(
+    const cmsis_nn_transpose_conv_params *transpose_conv_params, const cmsis_nn_dims *input_dims,
+    const cmsis_nn_dims *filter_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size, NULL, false, rc,
+      (ret = __real_arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size(
+          transpose_conv_params, input_dims, filter_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size_dsp
+int32_t __real_arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size_dsp(
+    const cmsis_nn_transpose_conv_params *transpose_conv_params, const cmsis_nn_dims *input_dims,
+    const cmsis_nn_dims *filter_dims);
+
+int32_t __wrap_arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size_dsp(
+    const cmsis_nn_transpose_conv_params *transpose_conv_params, const cmsis_nn_dims *input_dims,
+    const cmsis_nn_dims *filter_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size_dsp, NULL, false, rc,
+      (ret = __real_arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size_dsp(
+          transpose_conv_params, input_dims, filter_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
+// arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size_mve
+int32_t __real_arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size_mve(
+    const cmsis_nn_transpose_conv_params *transpose_conv_params, const cmsis_nn_dims *input_dims,
+    const cmsis_nn_dims *filter_dims);
+
+int32_t __wrap_arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size_mve(
+    const cmsis_nn_transpose_conv_params *transpose_conv_params, const cmsis_nn_dims *input_dims,
+    const cmsis_nn_dims *filter_dims)
+{
+  int32_t ret;
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size_mve, NULL, false, rc,
+      (ret = __real_arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size_mve(
+          transpose_conv_params, input_dims, filter_dims),
+       ARM_CMSIS_NN_SUCCESS));
+  return ret;
+}
+
 // arm_transpose_s16
 arm_cmsis_nn_status __real_arm_transpose_s16(
     const int16_t *input_data, int16_t *const output_data, const cmsis_nn_dims *const input_dims,
@@ -1758,11 +3908,12 @@ arm_cmsis_nn_status __wrap_arm_transpose_s16(
     const int16_t *input_data, int16_t *const output_data, const cmsis_nn_dims *const input_dims,
     const cmsis_nn_dims *const output_dims, const cmsis_nn_transpose_params *const transpose_params)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_transpose_s16(input_data, output_data, input_dims, output_dims, transpose_params);
-  capture_end_counters_and_log("arm_transpose_s16", toc_us(t0), rc);
-  log_kernel("arm_transpose_s16", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_unary(&shape, input_dims, output_dims, sizeof(int16_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_transpose_s16, &shape, output_data == input_data, rc,
+      __real_arm_transpose_s16(input_data, output_data, input_dims, output_dims, transpose_params));
   return rc;
 }
 
@@ -1775,11 +3926,12 @@ arm_cmsis_nn_status __wrap_arm_transpose_s8(
     const int8_t *input_data, int8_t *const output_data, const cmsis_nn_dims *const input_dims,
     const cmsis_nn_dims *const output_dims, const cmsis_nn_transpose_params *const transpose_params)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_transpose_s8(input_data, output_data, input_dims, output_dims, transpose_params);
-  capture_end_counters_and_log("arm_transpose_s8", toc_us(t0), rc);
-  log_kernel("arm_transpose_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_unary(&shape, input_dims, output_dims, sizeof(int8_t));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_transpose_s8, &shape, output_data == input_data, rc,
+      __real_arm_transpose_s8(input_data, output_data, input_dims, output_dims, transpose_params));
   return rc;
 }
 
@@ -1792,10 +3944,10 @@ arm_cmsis_nn_status __wrap_arm_vector_sum_s4(
     int32_t *vector_sum_buf, const int8_t *weights_s4, const cmsis_nn_dims *input_dims,
     const cmsis_nn_dims *output_dims, const int32_t lhs_offset, const int32_t *bias_data)
 {
-  uint32_t t0 = tic_us();
-  arm_cmsis_nn_status rc =
-      __real_arm_vector_sum_s4(vector_sum_buf, weights_s4, input_dims, output_dims, lhs_offset, bias_data);
-  log_kernel("arm_vector_sum_s4", toc_us(t0));
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_vector_sum_s4, NULL, false, rc,
+      __real_arm_vector_sum_s4(vector_sum_buf, weights_s4, input_dims, output_dims, lhs_offset, bias_data));
   return rc;
 }
 
@@ -1808,11 +3960,199 @@ arm_cmsis_nn_status __wrap_arm_vector_sum_s8(
     int32_t *vector_sum_buf, const int32_t vector_cols, const int32_t vector_rows, const int8_t *vector_data,
     const int32_t lhs_offset, const int32_t rhs_offset, const int32_t *bias_data)
 {
-  uint32_t t0 = tic_us();
-    capture_start_counters();
-  arm_cmsis_nn_status rc = __real_arm_vector_sum_s8(
-      vector_sum_buf, vector_cols, vector_rows, vector_data, lhs_offset, rhs_offset, bias_data);
-  capture_end_counters_and_log("arm_vector_sum_s8", toc_us(t0), rc);
-  log_kernel("arm_vector_sum_s8", toc_us(t0));
+  kernel_shape_record_t shape;
+  shape_weight_sum(&shape, vector_rows, vector_cols, 8);
+  arm_cmsis_nn_status rc;
+  KERNEL_MEASURE(
+      arm_vector_sum_s8, &shape, false, rc,
+      __real_arm_vector_sum_s8(
+          vector_sum_buf, vector_cols, vector_rows, vector_data, lhs_offset, rhs_offset, bias_data));
+  return rc;
+}
+// END GENERATED kernel wrappers
+#endif // KERNEL_TIMING_LEVEL > KERNEL_TIMING_NONE
+
+#if KERNEL_HELPERS
+// Internal helpers, aggregated per enclosing wrapped call (see log_helpers). Signatures follow
+// CMSIS-NN v7 arm_nnsupportfunctions.h. arm_nn_requantize is static inline and the MVE im2col is
+// inlined into the convolutions, so neither can be wrapped; their cost stays in the parent's
+// exclusive cycles. Generated by tools/gen_wrappers.py.
+// BEGIN GENERATED helper wrappers
+// arm_nn_depthwise_conv_nt_t_s8
+int8_t *__real_arm_nn_depthwise_conv_nt_t_s8(
+    const int8_t *lhs, const int8_t *rhs, const int32_t lhs_offset, const int32_t active_ch, const int32_t total_ch,
+    const int32_t *out_shift, const int32_t *out_mult, const int32_t out_offset, const int32_t activation_min,
+    const int32_t activation_max, const uint16_t row_x_col, const int32_t *const output_bias, int8_t *out);
+
+int8_t *__wrap_arm_nn_depthwise_conv_nt_t_s8(
+    const int8_t *lhs, const int8_t *rhs, const int32_t lhs_offset, const int32_t active_ch, const int32_t total_ch,
+    const int32_t *out_shift, const int32_t *out_mult, const int32_t out_offset, const int32_t activation_min,
+    const int32_t activation_max, const uint16_t row_x_col, const int32_t *const output_bias, int8_t *out)
+{
+  int8_t *ret;
+  HELPER_MEASURE(
+      KERNEL_HELPER_arm_nn_depthwise_conv_nt_t_s8, ret,
+      __real_arm_nn_depthwise_conv_nt_t_s8(
+          lhs, rhs, lhs_offset, active_ch, total_ch, out_shift, out_mult, out_offset, activation_min, activation_max,
+          row_x_col, output_bias, out));
+  return ret;
+}
+
+// arm_nn_mat_mul_core_1x_s8
+arm_cmsis_nn_status __real_arm_nn_mat_mul_core_1x_s8(
+    int32_t row_elements, const int32_t skipped_row_elements, const int8_t *row_base_ref, const int8_t *col_base_ref,
+    const int32_t out_ch, const cmsis_nn_conv_params *conv_params,
+    const cmsis_nn_per_channel_quant_params *quant_params, const int32_t *bias, int8_t *output);
+
+arm_cmsis_nn_status __wrap_arm_nn_mat_mul_core_1x_s8(
+    int32_t row_elements, const int32_t skipped_row_elements, const int8_t *row_base_ref, const int8_t *col_base_ref,
+    const int32_t out_ch, const cmsis_nn_conv_params *conv_params,
+    const cmsis_nn_per_channel_quant_params *quant_params, const int32_t *bias, int8_t *output)
+{
+  arm_cmsis_nn_status rc;
+  HELPER_MEASURE(
+      KERNEL_HELPER_arm_nn_mat_mul_core_1x_s8, rc,
+      __real_arm_nn_mat_mul_core_1x_s8(
+          row_elements, skipped_row_elements, row_base_ref, col_base_ref, out_ch, conv_params, quant_params, bias,
+          output));
+  return rc;
+}
+
+// arm_nn_mat_mul_core_4x_s8
+int8_t *__real_arm_nn_mat_mul_core_4x_s8(
+    const int32_t row_elements, const int32_t offset, const int8_t *row_base, const int8_t *col_base,
+    const int32_t out_ch, const cmsis_nn_conv_params *conv_params,
+    const cmsis_nn_per_channel_quant_params *quant_params, const int32_t *bias, int8_t *output);
+
+int8_t *__wrap_arm_nn_mat_mul_core_4x_s8(
+    const int32_t row_elements, const int32_t offset, const int8_t *row_base, const int8_t *col_base,
+    const int32_t out_ch, const cmsis_nn_conv_params *conv_params,
+    const cmsis_nn_per_channel_quant_params *quant_params, const int32_t *bias, int8_t *output)
+{
+  int8_t *ret;
+  HELPER_MEASURE(
+      KERNEL_HELPER_arm_nn_mat_mul_core_4x_s8, ret,
+      __real_arm_nn_mat_mul_core_4x_s8(
+          row_elements, offset, row_base, col_base, out_ch, conv_params, quant_params, bias, output));
+  return ret;
+}
+
+// arm_nn_mat_mult_nt_t_s8
+arm_cmsis_nn_status __real_arm_nn_mat_mult_nt_t_s8(
+    const int8_t *lhs, const int8_t *rhs, const int32_t *bias, int8_t *dst, const int32_t *dst_multipliers,
+    const int32_t *dst_shifts, const int32_t lhs_rows, const int32_t rhs_rows, const int32_t rhs_cols,
+    const int32_t lhs_offset, const int32_t dst_offset, const int32_t activation_min, const int32_t activation_max,
+    const int32_t row_address_offset, const int32_t lhs_cols_offset);
+
+arm_cmsis_nn_status __wrap_arm_nn_mat_mult_nt_t_s8(
+    const int8_t *lhs, const int8_t *rhs, const int32_t *bias, int8_t *dst, const int32_t *dst_multipliers,
+    const int32_t *dst_shifts, const int32_t lhs_rows, const int32_t rhs_rows, const int32_t rhs_cols,
+    const int32_t lhs_offset, const int32_t dst_offset, const int32_t activation_min, const int32_t activation_max,
+    const int32_t row_address_offset, const int32_t lhs_cols_offset)
+{
+  arm_cmsis_nn_status rc;
+  HELPER_MEASURE(
+      KERNEL_HELPER_arm_nn_mat_mult_nt_t_s8, rc,
+      __real_arm_nn_mat_mult_nt_t_s8(
+          lhs, rhs, bias, dst, dst_multipliers, dst_shifts, lhs_rows, rhs_rows, rhs_cols, lhs_offset, dst_offset,
+          activation_min, activation_max, row_address_offset, lhs_cols_offset));
+  return rc;
+}
+
+// arm_nn_vec_mat_mult_t_s8
+arm_cmsis_nn_status __real_arm_nn_vec_mat_mult_t_s8(
+    const int8_t *lhs, const int8_t *rhs, const int32_t *kernel_sum, const int32_t *bias, int8_t *dst,
+    const int32_t lhs_offset, const int32_t dst_offset, const int32_t dst_multiplier, const int32_t dst_shift,
+    const int32_t rhs_cols, const int32_t rhs_rows, const int32_t activation_min, const int32_t activation_max,
+    const int32_t address_offset, const int32_t rhs_offset);
+
+arm_cmsis_nn_status __wrap_arm_nn_vec_mat_mult_t_s8(
+    const int8_t *lhs, const int8_t *rhs, const int32_t *kernel_sum, const int32_t *bias, int8_t *dst,
+    const int32_t lhs_offset, const int32_t dst_offset, const int32_t dst_multiplier, const int32_t dst_shift,
+    const int32_t rhs_cols, const int32_t rhs_rows, const int32_t activation_min, const int32_t activation_max,
+    const int32_t address_offset, const int32_t rhs_offset)
+{
+  arm_cmsis_nn_status rc;
+  HELPER_MEASURE(
+      KERNEL_HELPER_arm_nn_vec_mat_mult_t_s8, rc,
+      __real_arm_nn_vec_mat_mult_t_s8(
+          lhs, rhs, kernel_sum, bias, dst, lhs_offset, dst_offset, dst_multiplier, dst_shift, rhs_cols, rhs_rows,
+          activation_min, activation_max, address_offset, rhs_offset));
   return rc;
 }
+// END GENERATED helper wrappers
+#endif
+
+#if KERNEL_TIMING_LEVEL > KERNEL_TIMING_NONE
+// Per-call cost of each runtime level up to the compile-time ceiling: the
+// minimum cycles of a wrapped one-element arm_relu_s8 against the real
+// call. Records and aggregates the benchmark itself produces are discarded.
+void kernel_timing_benchmark(uint32_t iterations)
+{
+  static int8_t in[1], out[1];
+  const kernel_id_t id = KERNEL_ID(arm_relu_s8);
+  const uint8_t saved = kernelLevel[id];
+
+  if (iterations == 0) iterations = KERNEL_BENCH_ITERATIONS;
+  init_dwt_if_needed();
+#if KERNEL_TIMING_LEVEL >= KERNEL_TIMING_CYCLES
+  // Only the logged call itself is benchmarked
+  uint32_t savedRepeat = repeatMax;
+  kernel_cache_mode_t savedCache = cacheMode;
+  bool savedMultiplex = pmuMultiplex;
+  repeatMax = 0;
+  cacheMode = KERNEL_CACHE_AS_IS;
+  pmuMultiplex = false;
+#if KERNEL_STATS
+  kernel_stats_t savedStats = kernelStats[id];
+#endif
+#if RESULT_STORE
+  kernel_result_t savedResult = kernelResults[id];
+#endif
+#endif
+
+  uint32_t real = UINT32_MAX;
+  for (uint32_t n = 0; n < iterations; n++) {
+    uint32_t t0 = DWT->CYCCNT;
+    (void)__real_arm_relu_s8(in, 0, 0, INT32_MAX, 0, out, 1);
+    uint32_t dt = DWT->CYCCNT - t0;
+    if (dt < real) real = dt;
+  }
+  for (uint32_t level = KERNEL_LEVEL_OFF; level <= KERNEL_TIMING_LEVEL; level++) {
+    kernelLevel[id] = (uint8_t)level;
+    uint32_t wrapped = UINT32_MAX;
+    for (uint32_t n = 0; n < iterations; n++) {
+      uint32_t t0 = DWT->CYCCNT;
+      (void)__wrap_arm_relu_s8(in, 0, 0, INT32_MAX, 0, out, 1);
+      uint32_t dt = DWT->CYCCNT - t0;
+      if (dt < wrapped) wrapped = dt;
+#if KERNEL_TIMING_LEVEL >= KERNEL_TIMING_CYCLES && KERNEL_TRACE_RING
+      traceCount = 0;
+#endif
+    }
+    kernelCalls[id] = 0;
+    ns_lp_printf(
+        "[LEVEL_BENCH] ceiling=%d level=%lu wrapped=%lu real=%lu overhead=%lu\n", KERNEL_TIMING_LEVEL,
+        (unsigned long)level, (unsigned long)wrapped, (unsigned long)real,
+        (unsigned long)(wrapped > real ? wrapped - real : 0));
+  }
+
+  kernelLevel[id] = saved;
+#if KERNEL_TIMING_LEVEL >= KERNEL_TIMING_CYCLES
+#if KERNEL_TRACE_RING
+  traceDropped = 0;
+#endif
+  repeatMax = savedRepeat;
+  cacheMode = savedCache;
+  pmuMultiplex = savedMultiplex;
+#if KERNEL_STATS
+  kernelStats[id] = savedStats;
+#endif
+#if RESULT_STORE
+  kernelResults[id] = savedResult;
+#endif
+#endif
+}
+#else
+void kernel_timing_benchmark(uint32_t iterations) { (void)iterations; }
+#endif
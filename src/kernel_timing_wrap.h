@@ -0,0 +1,512 @@
+#ifndef KERNEL_TIMING_WRAP_H
+#define KERNEL_TIMING_WRAP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Kernels instrumented by kernel_timing_wrap.c, generated with their wrappers
+// and WRAP_KERNELS in makefile_wrapper_call.mk by tools/gen_wrappers.py; the
+// position in this list is the kernel id carried in trace records.
+// BEGIN GENERATED kernel list
+#define KERNEL_LIST \
+  X(arm_add_s16) \
+  X(arm_add_s8) \
+  X(arm_avgpool_s16) \
+  X(arm_avgpool_s16_get_buffer_size) \
+  X(arm_avgpool_s16_get_buffer_size_dsp) \
+  X(arm_avgpool_s16_get_buffer_size_mve) \
+  X(arm_avgpool_s8) \
+  X(arm_avgpool_s8_get_buffer_size) \
+  X(arm_avgpool_s8_get_buffer_size_dsp) \
+  X(arm_avgpool_s8_get_buffer_size_mve) \
+  X(arm_batch_matmul_s16) \
+  X(arm_batch_matmul_s8) \
+  X(arm_convolve_1_x_n_s4) \
+  X(arm_convolve_1_x_n_s4_get_buffer_size) \
+  X(arm_convolve_1_x_n_s8) \
+  X(arm_convolve_1_x_n_s8_get_buffer_size) \
+  X(arm_convolve_1x1_s4) \
+  X(arm_convolve_1x1_s4_fast) \
+  X(arm_convolve_1x1_s4_fast_get_buffer_size) \
+  X(arm_convolve_1x1_s8) \
+  X(arm_convolve_1x1_s8_fast) \
+  X(arm_convolve_1x1_s8_fast_get_buffer_size) \
+  X(arm_convolve_s16) \
+  X(arm_convolve_s16_get_buffer_size) \
+  X(arm_convolve_s4) \
+  X(arm_convolve_s4_get_buffer_size) \
+  X(arm_convolve_s8) \
+  X(arm_convolve_s8_get_buffer_size) \
+  X(arm_convolve_weight_sum) \
+  X(arm_convolve_weight_sum_s4) \
+  X(arm_convolve_wrapper_s16) \
+  X(arm_convolve_wrapper_s16_get_buffer_size) \
+  X(arm_convolve_wrapper_s16_get_buffer_size_dsp) \
+  X(arm_convolve_wrapper_s16_get_buffer_size_mve) \
+  X(arm_convolve_wrapper_s4) \
+  X(arm_convolve_wrapper_s4_get_buffer_size) \
+  X(arm_convolve_wrapper_s4_get_buffer_size_dsp) \
+  X(arm_convolve_wrapper_s4_get_buffer_size_mve) \
+  X(arm_convolve_wrapper_s8) \
+  X(arm_convolve_wrapper_s8_get_buffer_size) \
+  X(arm_convolve_wrapper_s8_get_buffer_size_dsp) \
+  X(arm_convolve_wrapper_s8_get_buffer_size_mve) \
+  X(arm_depthwise_conv_3x3_s8) \
+  X(arm_depthwise_conv_fast_s16) \
+  X(arm_depthwise_conv_fast_s16_get_buffer_size) \
+  X(arm_depthwise_conv_s16) \
+  X(arm_depthwise_conv_s4) \
+  X(arm_depthwise_conv_s4_opt) \
+  X(arm_depthwise_conv_s4_opt_get_buffer_size) \
+  X(arm_depthwise_conv_s8) \
+  X(arm_depthwise_conv_s8_opt) \
+  X(arm_depthwise_conv_s8_opt_get_buffer_size) \
+  X(arm_depthwise_conv_wrapper_s16) \
+  X(arm_depthwise_conv_wrapper_s16_get_buffer_size) \
+  X(arm_depthwise_conv_wrapper_s16_get_buffer_size_dsp) \
+  X(arm_depthwise_conv_wrapper_s16_get_buffer_size_mve) \
+  X(arm_depthwise_conv_wrapper_s4) \
+  X(arm_depthwise_conv_wrapper_s4_get_buffer_size) \
+  X(arm_depthwise_conv_wrapper_s4_get_buffer_size_dsp) \
+  X(arm_depthwise_conv_wrapper_s4_get_buffer_size_mve) \
+  X(arm_depthwise_conv_wrapper_s8) \
+  X(arm_depthwise_conv_wrapper_s8_get_buffer_size) \
+  X(arm_depthwise_conv_wrapper_s8_get_buffer_size_dsp) \
+  X(arm_depthwise_conv_wrapper_s8_get_buffer_size_mve) \
+  X(arm_depthwise_convolve_weight_sum) \
+  X(arm_depthwise_weight_sum_s4) \
+  X(arm_elementwise_add_s16) \
+  X(arm_elementwise_add_s8) \
+  X(arm_elementwise_mul_s16) \
+  X(arm_elementwise_mul_s8) \
+  X(arm_fully_connected_per_channel_s8) \
+  X(arm_fully_connected_s16) \
+  X(arm_fully_connected_s16_get_buffer_size) \
+  X(arm_fully_connected_s16_get_buffer_size_dsp) \
+  X(arm_fully_connected_s16_get_buffer_size_mve) \
+  X(arm_fully_connected_s4) \
+  X(arm_fully_connected_s8) \
+  X(arm_fully_connected_s8_get_buffer_size) \
+  X(arm_fully_connected_s8_get_buffer_size_dsp) \
+  X(arm_fully_connected_s8_get_buffer_size_mve) \
+  X(arm_fully_connected_wrapper_s8) \
+  X(arm_hard_swish_compat_s16) \
+  X(arm_hard_swish_compat_s8) \
+  X(arm_hard_swish_precise_s16) \
+  X(arm_hard_swish_precise_s8) \
+  X(arm_leaky_relu_s8) \
+  X(arm_lstm_unidirectional_s16) \
+  X(arm_lstm_unidirectional_s8) \
+  X(arm_max_pool_s16) \
+  X(arm_max_pool_s8) \
+  X(arm_maximum_s16) \
+  X(arm_maximum_s8) \
+  X(arm_mean_s16) \
+  X(arm_mean_s8) \
+  X(arm_minimum_s16) \
+  X(arm_minimum_s8) \
+  X(arm_mul_s16) \
+  X(arm_mul_s8) \
+  X(arm_pad_s16) \
+  X(arm_pad_s8) \
+  X(arm_quantize_f32_s16) \
+  X(arm_quantize_f32_s8) \
+  X(arm_reduce_max_s16) \
+  X(arm_reduce_max_s8) \
+  X(arm_relu_s16) \
+  X(arm_relu_s8) \
+  X(arm_requantize_s16_s16) \
+  X(arm_requantize_s8_s8) \
+  X(arm_softmax_s16) \
+  X(arm_softmax_s8) \
+  X(arm_softmax_s8_s16) \
+  X(arm_strided_slice_s8) \
+  X(arm_svdf_s8) \
+  X(arm_svdf_state_s16_s8) \
+  X(arm_transpose_conv_s8) \
+  X(arm_transpose_conv_s8_get_buffer_size) \
+  X(arm_transpose_conv_s8_get_reverse_conv_buffer_size) \
+  X(arm_transpose_conv_wrapper_s8) \
+  X(arm_transpose_conv_wrapper_s8_get_buffer_size) \
+  X(arm_transpose_conv_wrapper_s8_get_buffer_size_dsp) \
+  X(arm_transpose_conv_wrapper_s8_get_buffer_size_mve) \
+  X(arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size) \
+  X(arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size_dsp) \
+  X(arm_transpose_conv_wrapper_s8_get_reverse_conv_buffer_size_mve) \
+  X(arm_transpose_s16) \
+  X(arm_transpose_s8) \
+  X(arm_vector_sum_s4) \
+  X(arm_vector_sum_s8)
+// END GENERATED kernel list
+
+#define KERNEL_ID(fn) KERNEL_ID_##fn
+
+#define X(fn) KERNEL_ID(fn),
+typedef enum { KERNEL_LIST KERNEL_COUNT } kernel_id_t;
+#undef X
+
+// CMSIS-NN internal helpers (arm_nnsupportfunctions.h) wrapped when
+// KERNEL_HELPERS=1, generated with WRAP_HELPERS by tools/gen_wrappers.py.
+// They run thousands of times per public kernel
+// call, so each call only adds its cycles to an aggregate for the wrapped
+// kernel it runs under; the aggregates are logged with that kernel's call.
+// Trace records identify helper h as kernel id KERNEL_COUNT + h.
+// BEGIN GENERATED helper list
+#define KERNEL_HELPER_LIST \
+  X(arm_nn_depthwise_conv_nt_t_s8) \
+  X(arm_nn_mat_mul_core_1x_s8) \
+  X(arm_nn_mat_mul_core_4x_s8) \
+  X(arm_nn_mat_mult_nt_t_s8) \
+  X(arm_nn_vec_mat_mult_t_s8)
+// END GENERATED helper list
+
+#define X(fn) KERNEL_HELPER_##fn,
+typedef enum { KERNEL_HELPER_LIST KERNEL_HELPER_COUNT } kernel_helper_t;
+#undef X
+
+#ifndef KERNEL_HELPERS
+#define KERNEL_HELPERS 1
+#endif
+
+// Compile-time instrumentation ceiling (KERNEL_TIMING_LEVEL in
+// makefile_wrapper_call.mk); code for the levels above it is not built.
+// NONE leaves the kernels unwrapped and the API empty, COUNT_ONLY only counts
+// calls, CYCLES adds per-call cycle records, shapes and helpers, DWT the DWT
+// counters and repeat mode, FULL_PMU the PMU events. Each matches the highest
+// kernel_level_t it allows.
+#define KERNEL_TIMING_NONE 0
+#define KERNEL_TIMING_COUNT_ONLY 1
+#define KERNEL_TIMING_CYCLES 2
+#define KERNEL_TIMING_DWT 3
+#define KERNEL_TIMING_FULL_PMU 4
+#ifndef KERNEL_TIMING_LEVEL
+#define KERNEL_TIMING_LEVEL KERNEL_TIMING_FULL_PMU
+#endif
+#if KERNEL_TIMING_LEVEL < KERNEL_TIMING_CYCLES
+#undef KERNEL_HELPERS
+#define KERNEL_HELPERS 0
+#endif
+
+// Wrapped calls in flight tracked by the shadow call stack. A parent's
+// counters exclude the instrumentation its nested wrapped calls run inside its
+// measured window; deeper calls are still measured, without that correction.
+#ifndef KERNEL_STACK_DEPTH
+#define KERNEL_STACK_DEPTH 8
+#endif
+
+// Route per-call results into the binary trace ring (1) or print them from
+// inside the wrapper as before (0).
+#ifndef KERNEL_TRACE_RING
+#define KERNEL_TRACE_RING 1
+#endif
+
+// Records held between drains. Must be a power of two.
+#ifndef KERNEL_TRACE_DEPTH
+#define KERNEL_TRACE_DEPTH 128
+#endif
+
+#define KERNEL_TRACE_VERSION 2
+#define KERNEL_TRACE_DWT_COUNT 6
+#define KERNEL_TRACE_PMU_COUNT 8
+
+// kernel_trace_record_t.flags
+#define KERNEL_TRACE_HAS_DWT 0x01
+#define KERNEL_TRACE_HAS_PMU 0x02
+#define KERNEL_TRACE_STATS   0x04  // repeat statistics, see kernel_timing_set_repeat()
+#define KERNEL_TRACE_COLD    0x08  // caches cleaned and invalidated before the call
+#define KERNEL_TRACE_WARM    0x10  // kernel ran once, unmeasured, before the call
+#define KERNEL_TRACE_PMU_GROUP 0x20  // PMU event group re-run, see KERNEL_PMU_MULTIPLEX
+#define KERNEL_TRACE_SHAPE   0x40  // kernel_shape_record_t for the call logged before it
+#define KERNEL_TRACE_CYCLES  0x80  // time-only call: dwt[0] holds its elapsed cycles
+                                   // (helper aggregate: time_us calls, dwt[0..2] sum, min, max)
+
+// One wrapped kernel invocation. Layout is mirrored by tools/trace_decode.py.
+// depth is the call's position in the shadow call stack (0 = called by the
+// test, 1 = called by another wrapped kernel, ...). Records are written when
+// a call returns, so a call's nested calls precede it in the ring.
+// A KERNEL_TRACE_STATS record instead summarizes the re-runs of the call
+// logged just before it: time_us holds the re-run count and dwt[] the
+// min, median, p90, p99, mean and stddev of their corrected cycle counts.
+// A KERNEL_TRACE_PMU_GROUP record holds one re-run of that call with event
+// group time_us programmed: dwt[] as usual, pmu[] the group's events.
+typedef struct {
+  uint8_t  kernel_id;                     // kernel_id_t
+  uint8_t  depth;
+  uint8_t  flags;                         // KERNEL_TRACE_HAS_*
+  int8_t   status;                        // arm_cmsis_nn_status
+  uint32_t time_us;
+  uint32_t dwt[KERNEL_TRACE_DWT_COUNT];   // cyccnt, cpicnt, exccnt, sleepcnt, lsucnt, foldcnt
+  uint32_t pmu[KERNEL_TRACE_PMU_COUNT];   // deltas for the enabled PMU event slots
+} kernel_trace_record_t;
+
+// PMU event catalogue, X(name, ARMv8.1-M event id). Events are counted
+// 32 bits wide, which chains two hardware counters, so the catalogue is
+// programmed KERNEL_PMU_GROUP_SIZE events at a time in list order. Group 0 is
+// live on every logged call; with KERNEL_PMU_MULTIPLEX the remaining groups
+// are collected by re-running each outermost call once per group (stateful
+// and in-place calls are not re-run: group 0 only). Define
+// KERNEL_PMU_EVENT_LIST to profile a different set.
+#ifndef KERNEL_PMU_EVENT_LIST
+#define KERNEL_PMU_EVENT_LIST                  \
+  X(CPU_CYCLES, 0x0011)                        \
+  X(INST_RETIRED, 0x0008)                      \
+  X(MVE_INST_RETIRED, 0x0200)                  \
+  X(MVE_INT_MAC_RETIRED, 0x0228)               \
+  X(MEM_ACCESS, 0x0013)                        \
+  X(BUS_ACCESS, 0x0019)                        \
+  X(BUS_CYCLES, 0x001D)                        \
+  X(L1D_CACHE, 0x0004)                         \
+  X(L1D_CACHE_REFILL, 0x0003)                  \
+  X(L1I_CACHE_REFILL, 0x0001)                  \
+  X(STALL_FRONTEND, 0x0023)                    \
+  X(STALL_BACKEND, 0x0024)                     \
+  X(MVE_STALL, 0x02CC)                         \
+  X(MVE_STALL_RESOURCE_MEM, 0x02CE)            \
+  X(MVE_STALL_DEPENDENCY, 0x02D4)              \
+  X(STALL_BACKEND_MEM, 0x4005)                 \
+  X(BR_RETIRED, 0x0021)                        \
+  X(BR_MIS_PRED_RETIRED, 0x0022)               \
+  X(LE_RETIRED, 0x0100)                        \
+  X(LE_CANCEL, 0x0108)
+#endif
+
+#ifndef KERNEL_PMU_GROUP_SIZE
+#define KERNEL_PMU_GROUP_SIZE 4
+#endif
+
+#ifndef KERNEL_PMU_MULTIPLEX
+#define KERNEL_PMU_MULTIPLEX 0
+#endif
+
+// Operand shapes and theoretical work of one wrapped call, filled in by the
+// wrapper before the call and logged after it. Dims are n, h, w, c; tiles
+// are h, w. macs counts multiply-accumulates of conv, depthwise, transpose
+// conv, fully connected, batch matmul, elementwise mul and weight sums (0
+// elsewhere); bytes counts each input, weight, bias and output element once.
+typedef struct {
+  uint8_t  kernel_id;
+  uint8_t  depth;
+  uint8_t  flags;                         // KERNEL_TRACE_SHAPE
+  uint8_t  peak_macs;                     // MVE peak MACs/cycle for the operand type
+  uint32_t macs;
+  uint32_t bytes;
+  uint32_t input[4];
+  uint32_t output[4];
+  uint16_t filter[4];
+  uint8_t  stride[2];
+  uint8_t  padding[2];
+  uint8_t  dilation[2];
+  uint8_t  reserved[6];
+} kernel_shape_record_t;
+
+// Cortex-M55 MVE is dual-beat: 64 bits of vector work per cycle, i.e. 8 int8
+// or 4 int16 multiply-accumulates.
+#ifndef KERNEL_MVE_PEAK_MACS_S8
+#define KERNEL_MVE_PEAK_MACS_S8 8
+#endif
+#ifndef KERNEL_MVE_PEAK_MACS_S16
+#define KERNEL_MVE_PEAK_MACS_S16 4
+#endif
+
+// Core clock used to convert cycles to microseconds. Defaults to the CMSIS
+// SystemCoreClock; define it when the power mode changes the clock behind
+// SystemCoreClock's back.
+#ifndef KERNEL_CPU_HZ
+#define KERNEL_CPU_HZ SystemCoreClock
+#endif
+
+// Free-running cycle clock: DWT CYCCNT extended to 64 bits in software and
+// never reset, so nested wrapped calls and harness-level timing can all take
+// differences of it. A wrap of the 32-bit counter is detected on each read,
+// so it must be read at least once every 2^32 cycles (the harness reads it
+// per test). Not for use from interrupt handlers. Where the harness defines
+// HOST_CYCLES64() (the host build), that 64-bit clock is read instead.
+uint64_t kernel_cycles_now(void);
+
+// Start the DWT behind kernel_cycles_now() unless it already runs. Other
+// profilers (src/aot_profile.c) call this rather than ns_init_perf_profiler(),
+// which zeroes CYCCNT and would read as a wrap of the 64-bit clock.
+void kernel_timing_init(void);
+
+// Whether the wrappers program the PMU (FULL_PMU builds): other profilers
+// must not reprogram it underneath them.
+bool kernel_timing_owns_pmu(void);
+
+// Cycles -> microseconds at KERNEL_CPU_HZ.
+uint32_t kernel_cycles_to_us(uint64_t cycles);
+
+// Empty wrapped calls timed by kernel_timing_calibrate(iterations = 0).
+#ifndef KERNEL_CALIB_ITERATIONS
+#define KERNEL_CALIB_ITERATIONS 256
+#endif
+
+// Measure the instrumentation overhead inside the timed window by running the
+// wrapper sequence around an empty call, and keep the per-counter minimum as a
+// baseline (PMU: per catalogue event, one pass per group). Prints one [CALIB]
+// line; the printf path then reports raw and overhead-corrected (_corr)
+// counters, and the host tools correct [TRACE] records the same way. Call
+// once at harness start.
+void kernel_timing_calibrate(uint32_t iterations);
+
+// Repeat mode: after each outermost wrapped call is logged, re-run the real
+// kernel with the same arguments and summarize the cycle counts of the
+// re-runs. Stops once the 95% confidence interval of the mean is within
+// ci_permille/1000 of the mean (after KERNEL_REPEAT_MIN re-runs), or after
+// max_repeats re-runs. Defaults come from KERNEL_REPEAT_MAX/KERNEL_REPEAT_CI.
+#ifndef KERNEL_REPEAT_MAX
+#define KERNEL_REPEAT_MAX 0  // 0 = off
+#endif
+#ifndef KERNEL_REPEAT_CI
+#define KERNEL_REPEAT_CI 10  // permille
+#endif
+#ifndef KERNEL_REPEAT_MIN
+#define KERNEL_REPEAT_MIN 5
+#endif
+// Upper bound on max_repeats; sizes the on-device sample buffer.
+#ifndef KERNEL_REPEAT_CAP
+#define KERNEL_REPEAT_CAP 128
+#endif
+
+// Kernels that are re-run must be pure functions of their arguments: the
+// output buffer then still holds the result of the first (logged) call.
+// Stateful kernels (SVDF, LSTM) are never re-run, nor is a call whose output
+// pointer equals one of its input pointers (in place, as the AOT arena plans
+// pooling and softmax): a re-run would read its own output. Wrapped kernels
+// called from inside a re-run are executed without measurement.
+void kernel_timing_set_repeat(uint32_t max_repeats, uint32_t ci_permille);
+
+// Cache state each outermost wrapped call is measured in. COLD cleans and
+// invalidates the L1 I/D caches before the call (and before each repeat
+// re-run), WARM runs the kernel once unmeasured first, COLD_WARM logs a cold
+// call followed by a warm one so the cold-start penalty can be read off
+// side by side. Records carry KERNEL_TRACE_COLD/KERNEL_TRACE_WARM. Stateful
+// kernels and in-place calls are measured as is in WARM and COLD_WARM,
+// without the extra run.
+typedef enum {
+  KERNEL_CACHE_AS_IS = 0,
+  KERNEL_CACHE_COLD = 1,
+  KERNEL_CACHE_WARM = 2,
+  KERNEL_CACHE_COLD_WARM = 3,
+} kernel_cache_mode_t;
+
+#ifndef KERNEL_CACHE_MODE
+#define KERNEL_CACHE_MODE 0
+#endif
+
+void kernel_timing_set_cache_mode(kernel_cache_mode_t mode);
+
+// Turn KERNEL_PMU_MULTIPLEX re-runs on or off at runtime.
+void kernel_timing_set_pmu_multiplex(bool enable);
+
+// Per-kernel instrumentation level. OFF calls the real kernel after one
+// predictable branch; COUNT only counts calls ([COUNT] lines at each drain);
+// TIME logs cycles; DWT adds the DWT counters; PMU adds the PMU events and,
+// with multiplexing, the re-runs per event group. Every kernel starts at
+// KERNEL_LEVEL_DEFAULT. Levels above KERNEL_TIMING_LEVEL are clamped to it.
+typedef enum {
+  KERNEL_LEVEL_OFF = 0,
+  KERNEL_LEVEL_COUNT = 1,
+  KERNEL_LEVEL_TIME = 2,
+  KERNEL_LEVEL_DWT = 3,
+  KERNEL_LEVEL_PMU = 4,
+} kernel_level_t;
+
+#ifndef KERNEL_LEVEL_DEFAULT
+#define KERNEL_LEVEL_DEFAULT KERNEL_LEVEL_PMU
+#endif
+
+void kernel_timing_set_level(kernel_id_t id, kernel_level_t level);
+
+// Name pattern match over [p, end), shared by the kernel filter and the test
+// selector: '*' matches any run of characters, '?' any one character, and
+// letters compare case-insensitively.
+bool kernel_name_match(const char *p, const char *end, const char *name);
+
+// Set the level of every kernel whose name matches one of the comma-separated
+// kernel_name_match() patterns (e.g. "arm_convolve_*,arm_softmax_s8").
+// Returns the number of kernels matched. Call outside any measured region.
+uint32_t kernel_timing_set_level_match(const char *patterns, kernel_level_t level);
+
+// Per-kernel running aggregates of every logged call: count, sum, min, max,
+// sum of squares and a log2 histogram of the cycles (overhead-corrected at
+// the DWT and PMU levels). They live on the device in a table indexed by
+// kernel id; kernel_stats_dump() prints one [STATS] line per kernel called,
+// and the test runner dumps them when the suite completes.
+#ifndef KERNEL_STATS
+#define KERNEL_STATS 1
+#endif
+#ifndef KERNEL_STATS_BUCKETS
+#define KERNEL_STATS_BUCKETS 20
+#endif
+// Bucket b holds [2^(b + MIN_LOG2), 2^(b + 1 + MIN_LOG2)) cycles, so the first
+// holds everything below 2^(MIN_LOG2 + 1) and the last everything above
+#ifndef KERNEL_STATS_MIN_LOG2
+#define KERNEL_STATS_MIN_LOG2 6
+#endif
+
+void kernel_stats_dump(const char *label);
+void kernel_stats_reset(void);
+
+// Count and cycle sum of kernel id's logged calls since the last reset; false
+// when it has none, or KERNEL_STATS is 0.
+bool kernel_stats_get(kernel_id_t id, uint32_t *count, uint64_t *sum);
+
+// Per-call records (trace ring or printf lines). Turn them off for long soak
+// runs and keep only the KERNEL_STATS aggregates.
+#ifndef KERNEL_RECORDS
+#define KERNEL_RECORDS 1
+#endif
+
+void kernel_timing_set_records(bool enable);
+
+// Cycles spent in outermost wrapped calls (as logged, so without the
+// instrumentation, re-runs and warm-ups around them) since the previous call.
+// The test runner takes them per test. 0 below KERNEL_TIMING_CYCLES.
+uint64_t kernel_timing_take_cycles(void);
+
+// Print [LEVEL_BENCH] lines with the per-call cycle cost of each runtime level
+// up to KERNEL_TIMING_LEVEL, measured on a one-element arm_relu_s8. Call
+// outside any measured region; 0 = KERNEL_BENCH_ITERATIONS.
+#ifndef KERNEL_BENCH_ITERATIONS
+#define KERNEL_BENCH_ITERATIONS 100
+#endif
+void kernel_timing_benchmark(uint32_t iterations);
+
+// Instruction-count markers for emulated runs (qemu/). kernel_mark() is an
+// empty call that the TCG plugin qemu/plugin/kernel_insns.c watches for; it
+// reads op and arg from r0 and r1. START/END bracket the logged call of a
+// kernel (arg = kernel id). PAUSE/RESUME bracket each wrapper around that, so
+// an enclosing kernel's count leaves out the nested wrapper's instrumentation.
+// TEST (arg = test index) tags the calls that follow. 0 = compiled out.
+#ifndef KERNEL_MARKERS
+#define KERNEL_MARKERS 0
+#endif
+
+typedef enum {
+  KERNEL_MARK_START = 1,
+  KERNEL_MARK_END = 2,
+  KERNEL_MARK_PAUSE = 3,
+  KERNEL_MARK_RESUME = 4,
+  KERNEL_MARK_TEST = 5,
+} kernel_mark_t;
+
+#if KERNEL_MARKERS
+void kernel_mark(kernel_mark_t op, uint32_t arg);
+#define KERNEL_MARK(op, arg) kernel_mark((op), (arg))
+#else
+#define KERNEL_MARK(op, arg) ((void)0)
+#endif
+
+// Print every record captured since the last drain, tagged with test_name, and
+// empty the ring. Call between tests, never from inside a measured region.
+void kernel_trace_drain(const char *test_name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // KERNEL_TIMING_WRAP_H
@@ -50,10 +50,9 @@ int main(void)
     while (1) {
         if (!test_library_done()) {
             test_library_step(0);  
-        } else {
+        } else if (!test_library_poll()) {
             ns_lp_printf("[CMSIS-NN] All tests done. Idling...\n");
             ns_delay_us(5000000);
         }
-        ns_delay_us(20000);
     }
 }
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ns_ambiqsuite_harness.h"
+#include "result_store.h"
+
+#if RESULT_STORE
+_Static_assert(sizeof(result_record_t) == 16, "record layout changed; update tools/result_store.py");
+_Static_assert(sizeof(result_store_header_t) == 40, "header layout changed; update tools/result_store.py");
+
+// Not cleared by the startup code, so the store outlives a reset (not a power cycle)
+#ifndef RESULT_STORE_RETAINED
+#if defined(__ARM_ARCH)
+#define RESULT_STORE_RETAINED __attribute__((section(".noinit"), aligned(32)))
+#else
+#define RESULT_STORE_RETAINED
+#endif
+#endif
+
+static RESULT_STORE_RETAINED struct {
+  result_store_header_t hdr;
+  result_record_t rec[RESULT_STORE_RECORDS];
+} store;
+
+static int storeOpen = 0;
+
+#if !defined(__ARM_ARCH)
+// RESULT_STORE_FILE in the environment overrides the built-in path, so
+// parallel host shards each keep their own store
+static const char *store_path(void)
+{
+  const char *path = getenv("RESULT_STORE_FILE");
+  return path && *path ? path : RESULT_STORE_FILE;
+}
+#endif
+
+static int store_valid(void)
+{
+  return store.hdr.magic == RESULT_STORE_MAGIC && store.hdr.version == RESULT_STORE_VERSION &&
+         store.hdr.record_size == sizeof(result_record_t) && store.hdr.capacity == RESULT_STORE_RECORDS &&
+         store.hdr.count <= RESULT_STORE_RECORDS && store.hdr.first < RESULT_STORE_RECORDS;
+}
+
+// Slots in use from slot 0: the whole array once the ring has wrapped
+static uint32_t store_span(void)
+{
+  uint32_t end = store.hdr.first + store.hdr.count;
+  return end < RESULT_STORE_RECORDS ? end : RESULT_STORE_RECORDS;
+}
+
+void result_store_clear(void)
+{
+  memset(&store.hdr, 0, sizeof(store.hdr));
+  store.hdr.magic = RESULT_STORE_MAGIC;
+  store.hdr.version = RESULT_STORE_VERSION;
+  store.hdr.record_size = sizeof(result_record_t);
+  store.hdr.capacity = RESULT_STORE_RECORDS;
+  storeOpen = 1;
+  result_store_commit();
+}
+
+// Adopt what the retained memory (or the host file) holds, or start empty
+static void store_open(void)
+{
+  if (storeOpen) return;
+  storeOpen = 1;
+#if !defined(__ARM_ARCH)
+  FILE *f = fopen(store_path(), "rb");
+  if (f) {
+    if (fread(&store, 1, sizeof(store), f) < sizeof(store.hdr)) store.hdr.magic = 0;
+    fclose(f);
+  }
+#endif
+  if (!store_valid()) result_store_clear();
+}
+
+void result_store_commit(void)
+{
+#if defined(__ARM_ARCH)
+#if defined(__DCACHE_PRESENT) && __DCACHE_PRESENT
+  SCB_CleanDCache_by_Addr((uint32_t *)&store, (int32_t)sizeof(store));
+#endif
+#else
+  FILE *f = fopen(store_path(), "wb");
+  if (f) {
+    fwrite(&store, 1, sizeof(store.hdr) + store_span() * sizeof(result_record_t), f);
+    fclose(f);
+  }
+#endif
+}
+
+// Make room by evicting the oldest run: its records up to the next RESULT_RUN.
+// Fails when the oldest run is the one being written.
+static int evict_oldest_run(void)
+{
+  const result_record_t *oldest = &store.rec[store.hdr.first];
+  if (oldest->kind == RESULT_RUN && oldest->a == store.hdr.run_id) return 0;
+  uint32_t n = 1;
+  while (n < store.hdr.count && store.rec[(store.hdr.first + n) % RESULT_STORE_RECORDS].kind != RESULT_RUN) n++;
+  store.hdr.evicted += oldest->kind == RESULT_RUN;
+  store.hdr.first = (store.hdr.first + n) % RESULT_STORE_RECORDS;
+  store.hdr.count -= n;
+  return 1;
+}
+
+void result_store_append(result_kind_t kind, uint8_t code, uint32_t a, uint32_t b, uint32_t c)
+{
+  store_open();
+  if (store.hdr.count == RESULT_STORE_RECORDS && !evict_oldest_run()) {
+    store.hdr.dropped++;
+    return;
+  }
+  result_record_t *r = &store.rec[(store.hdr.first + store.hdr.count++) % RESULT_STORE_RECORDS];
+  r->kind = (uint8_t)kind;
+  r->code = code;
+  r->test = store.hdr.test;
+  r->a = a;
+  r->b = b;
+  r->c = c;
+}
+
+void result_store_begin_run(uint32_t build, uint32_t tests)
+{
+  store_open();
+  store.hdr.run_id++;
+  store.hdr.build = build;
+  store.hdr.test = 0;
+  result_store_append(RESULT_RUN, 0, store.hdr.run_id, build, tests);
+  result_store_commit();
+}
+
+void result_store_set_test(uint16_t test)
+{
+  store_open();
+  store.hdr.test = test;
+}
+
+static void dump_hex(const void *p, size_t n)
+{
+  static const char hex[] = "0123456789abcdef";
+  char line[2 * sizeof(result_store_header_t) + 1];
+  const uint8_t *bytes = (const uint8_t *)p;
+  for (size_t i = 0; i < n; i++) {
+    line[2 * i] = hex[bytes[i] >> 4];
+    line[2 * i + 1] = hex[bytes[i] & 0xF];
+  }
+  line[2 * n] = '\0';
+  ns_lp_printf("[STORE] %s\n", line);
+}
+
+void result_store_dump(void)
+{
+  store_open();
+  ns_lp_printf("[STORE] begin records=%lu dropped=%lu evicted=%lu run=%lu\n", (unsigned long)store.hdr.count,
+               (unsigned long)store.hdr.dropped, (unsigned long)store.hdr.evicted, (unsigned long)store.hdr.run_id);
+  dump_hex(&store.hdr, sizeof(store.hdr));
+  // Slot order, like a memory dump: the decoder starts at hdr.first
+  for (uint32_t i = 0; i < store_span(); i++) {
+    dump_hex(&store.rec[i], sizeof(result_record_t));
+  }
+  ns_lp_printf("[STORE] end\n");
+}
+#endif
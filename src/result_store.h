@@ -0,0 +1,98 @@
+#ifndef RESULT_STORE_H
+#define RESULT_STORE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Compact binary results kept across resets: retained SRAM on the device, a
+// file on a host. test_library.c opens a run and appends a record per test;
+// kernel_trace_drain() appends one per kernel the test called. Read back in
+// bulk with result_store_dump() (or a memory dump of the store) and decode
+// with tools/result_store.py. The records form a ring: when it is full the
+// oldest whole run is evicted (counted in evicted), never part of one. Records
+// of a run that fills the store by itself are counted as dropped.
+#ifndef RESULT_STORE
+#define RESULT_STORE 1
+#endif
+#ifndef RESULT_STORE_RECORDS
+#define RESULT_STORE_RECORDS 512
+#endif
+#ifndef RESULT_STORE_FILE
+#define RESULT_STORE_FILE "result_store.bin"
+#endif
+
+#define RESULT_STORE_MAGIC 0x53524B54u  // "TKRS"
+#define RESULT_STORE_VERSION 2
+
+typedef enum {
+  RESULT_RUN = 1,     // a = run id, b = build hash, c = tests selected
+  RESULT_TEST = 2,    // code = outcome, a = wall cycles, b = kernel cycles, c = failures (reset status for RESET)
+  RESULT_KERNEL = 3,  // code = kernel id, a = calls, b = cycles (sum), c = max cycles
+} result_kind_t;
+
+// Outcome codes of RESULT_TEST records
+enum { RESULT_PASS = 1, RESULT_FAIL = 2, RESULT_TIMEOUT = 3, RESULT_RESET = 4 };
+
+typedef struct {
+  uint8_t kind;   // result_kind_t
+  uint8_t code;
+  uint16_t test;  // test index in the registry
+  uint32_t a;
+  uint32_t b;
+  uint32_t c;
+} result_record_t;
+
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t record_size;
+  uint32_t capacity;
+  uint32_t count;    // records held
+  uint32_t first;    // slot of the oldest record
+  uint32_t dropped;  // records that did not fit in their own run
+  uint32_t evicted;  // oldest runs evicted to make room
+  uint32_t run_id;
+  uint32_t build;
+  uint16_t test;  // current test, stamped on appended records
+  uint16_t reserved;
+} result_store_header_t;
+
+#if RESULT_STORE
+// Start a run: bump the run id and append its RESULT_RUN record
+void result_store_begin_run(uint32_t build, uint32_t tests);
+// Test the following records belong to
+void result_store_set_test(uint16_t test);
+void result_store_append(result_kind_t kind, uint8_t code, uint32_t a, uint32_t b, uint32_t c);
+// Make appended records survive a reset (D-cache clean, or file write on a host)
+void result_store_commit(void);
+// Print the header and records as [STORE] hex lines
+void result_store_dump(void);
+void result_store_clear(void);
+#else
+static inline void result_store_begin_run(uint32_t build, uint32_t tests)
+{
+  (void)build;
+  (void)tests;
+}
+static inline void result_store_set_test(uint16_t test) { (void)test; }
+static inline void result_store_append(result_kind_t kind, uint8_t code, uint32_t a, uint32_t b, uint32_t c)
+{
+  (void)kind;
+  (void)code;
+  (void)a;
+  (void)b;
+  (void)c;
+}
+static inline void result_store_commit(void) {}
+static inline void result_store_dump(void) {}
+static inline void result_store_clear(void) {}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RESULT_STORE_H
@@ -1,6 +1,8 @@
 #ifndef TEST_LIBRARY_H
 #define TEST_LIBRARY_H
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -377,18 +379,35 @@ extern "C" {
 #define DS_CNN_TEST_LIST \
   X(weight_presum)
 
+// HeliosAOT model tests (modules/aot-unit-test)
+#define AOT_TEST_LIST \
+  X(aot_ds_cnn_profile) \
+  X(aot_ds_cnn_benchmark)
+
+// Self-checks of the timing wrappers (src/kernel_timing_wrap.c)
+#define TIMING_TEST_LIST \
+  X(timing_nested_attribution)
+
+// Categories built into the image, in run order. Comment one out to leave its
+// tests out of the build; choose among the built ones at runtime with
+// test_library_select().
+#define TEST_CATEGORIES \
+  CATEGORY(CONVOLUTION) \
+  // CATEGORY(FULLY_CONNECTED) \
+  // CATEGORY(POOLING) \
+  // CATEGORY(ARITHMETIC) \
+  // CATEGORY(ACTIVATION) \
+  // CATEGORY(QUANTIZATION) \
+  // CATEGORY(LSTM) \
+  // CATEGORY(UTILITY) \
+  // CATEGORY(SVDF) \
+  // CATEGORY(DS_CNN) \
+  // CATEGORY(TIMING) \
+  // CATEGORY(AOT)
+
 // Combined test list
-#define TEST_LIST \
-  CONVOLUTION_TEST_LIST \
-  // FULLY_CONNECTED_TEST_LIST \
-  // POOLING_TEST_LIST \
-  // ARITHMETIC_TEST_LIST \
-  // ACTIVATION_TEST_LIST \
-  // QUANTIZATION_TEST_LIST \
-  // LSTM_TEST_LIST \
-  // UTILITY_TEST_LIST \
-  // SVDF_TEST_LIST \
-  // DS_CNN_TEST_LIST
+#define CATEGORY(cat) cat##_TEST_LIST
+#define TEST_LIST TEST_CATEGORIES
 
 // Tests that hang so I leave them here for now: 
 //   X(ds_cnn_l_s8_inference) \
@@ -422,6 +441,32 @@ int  test_library_done(void);
 // Reset the internal cursor back to the first test.
 void test_library_reset(void);
 
+// Select the tests the next run covers and reset the cursor. The expression is
+// a list of terms separated by commas or spaces: a category (@pooling), a
+// test name pattern (kernel_name_match()) or an index range (10-20, 7, 300-).
+// A term starting with '!' removes its matches. With no positive term every
+// test is selected, so "" runs the whole list. Returns the number selected.
+size_t test_library_select(const char *expr);
+
+// Narrow the selection to shard k of n (0 <= k < n): every n-th selected test
+// starting at the k-th, so n processes running shards 0..n-1 cover the
+// selection once between them. Returns the number kept.
+size_t test_library_shard(unsigned k, unsigned n);
+
+// Tests of the current run that have not passed: failed, timed out, reset or
+// not run.
+int test_library_failed(void);
+
+// Read the command channel once: a selection expression starts a new run
+// (returns 1), "list" prints the registry, "store" dumps the result store and
+// "store clear" empties it. Returns 0 when there is no command.
+int test_library_poll(void);
+
+// Command channel behind test_library_poll(): copy one NUL-terminated command
+// into buf and return its length, or 0 if none is pending. Weak; the default
+// reads the test_command mailbox on the device and a line of stdin on a host.
+int test_command_read(char *buf, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -22,7 +22,8 @@ extern volatile int __unity_failures;
    do {                                   \
      if (!(cond)) {                       \
        __unity_failures++;                \
-       __unity_on_fail(MACRO, MSG);       \
+       if (__unity_on_fail)               \
+         __unity_on_fail(MACRO, MSG);     \
      }                                    \
    } while (0)
  
@@ -0,0 +1,264 @@
+#!/usr/bin/env python3
+"""Plan the activation arena of a HeliosAOT model from tensor lifetimes.
+
+Reads the operator list of modules/aot-unit-test/src/aot_model.c, in the
+order aot_model_run() calls it. Each operator's output tensor lives from the
+operator that writes it to the last one that reads it. Its size comes from
+the operator's source: output dims, or rows x row size for softmax. Tensors
+whose lifetimes overlap get disjoint offsets in model_buffer. Two
+offset-assignment heuristics run, and the smaller arena wins:
+
+- greedy by size: largest tensor first, at the lowest offset that fits
+  between the tensors already placed that are live at the same time
+- greedy by order: tensors in the order they are written, same placement
+
+An operator may write its output over its input when that input dies there.
+The operator's header declares whether it can with AOT_<OP>_INPLACE: 1 means
+the run wrapper accepts output == input (and so is not __restrict), 0 means
+it never may. An undeclared operator runs in place only when named with
+--inplace. An in-place output shares the input's block, at the same offset.
+The timing wrappers detect such a call (output == input) and do not re-run it
+in the WARM, COLD_WARM, repeat or PMU multiplex modes, so one plan serves all.
+
+The plan goes to includes-api/aot_model_plan.h as the arena size and one
+offset per operator output, AOT_PLAN_<OP>. aot_model.c sizes model_buffer
+and passes every arena pointer with those macros, so a consumer names the
+tensor it reads. --apply converts a freshly generated aot_model.c (numeric
+`buffer + N` offsets) to that form. --check only reports whether the header
+is up to date.
+
+    python3 tools/aot_plan.py
+    python3 tools/aot_plan.py --apply       # after regenerating the model
+    python3 tools/aot_plan.py --inplace softmax_12 --dry-run
+"""
+
+import argparse
+import re
+import sys
+from pathlib import Path
+
+REPO = Path(__file__).resolve().parent.parent
+AOT = REPO / "modules" / "aot-unit-test"
+
+RUN_RE = re.compile(r"status = aot_(?P<op>\w+)_run\((?P<args>[^;]*)\);")
+BUFFER_RE = re.compile(r"model_buffer\[(?P<size>\w+)\]")
+ARENA_RE = re.compile(r"^\(int8_t \*\)\(buffer \+ (?P<off>\w+)\)$")
+DIMS_RE = re.compile(r"_output_dims = \{ \.n = (\d+), \.h = (\d+), \.w = (\d+), \.c = (\d+) \}")
+ROWS_RE = re.compile(r"_num_rows = (\d+);.*?_row_size = (\d+);", re.S)
+TYPE_RE = re.compile(r"@brief\s+Autogenerated AOT (\w+) kernel")
+ELEM_RE = re.compile(r"_run\(const (\w+)\*")
+ELEM_SIZE = {"int8_t": 1, "uint8_t": 1, "int16_t": 2, "int32_t": 4, "float": 4}
+
+
+class Tensor:
+    def __init__(self, op, size):
+        self.op = op            # operator that writes it
+        self.size = size
+        self.first = self.last = None  # run steps (call order) it is live over
+        self.offset = None
+        self.alias = None       # tensor whose block it shares (in-place)
+
+
+def macro(op):
+    return f"AOT_PLAN_{op.upper()}"
+
+
+def op_info(op):
+    """(type, output bytes, AOT_<OP>_INPLACE: True, False or None if undeclared) from the operator's source and header."""
+    src = (AOT / "src" / f"aot_{op}.c").read_text()
+    hdr = (AOT / "includes-api" / f"aot_{op}.h").read_text()
+    kind = TYPE_RE.search(src)
+    elem = ELEM_RE.search(src)
+    dims = DIMS_RE.search(src)
+    rows = ROWS_RE.search(src)
+    if dims:
+        count = 1
+        for d in dims.groups():
+            count *= int(d)
+    elif rows:
+        count = int(rows.group(1)) * int(rows.group(2))
+    else:
+        raise SystemExit(f"aot_{op}.c: no output dims or softmax rows to size the output from")
+    flag = re.search(r"#define AOT_%s_INPLACE\s+(\d)" % op.upper(), hdr)
+    inplace = bool(int(flag.group(1))) if flag else None
+    if inplace and "__restrict" in hdr:
+        raise SystemExit(f"aot_{op}.h declares AOT_{op.upper()}_INPLACE 1 but its run wrapper is __restrict")
+    return kind.group(1) if kind else "?", count * ELEM_SIZE.get(elem.group(1) if elem else "int8_t", 1), inplace
+
+
+def parse_model(text):
+    """Operators in run order, each (name, input expr, output expr)."""
+    run = text[text.index("int32_t aot_model_run(") :]
+    ops = []
+    for m in RUN_RE.finditer(run):
+        args = [a.strip() for a in m.group("args").split(",")]
+        if len(args) != 2:
+            raise SystemExit(f"aot_{m.group('op')}_run: expected (input, output), got {m.group('args')}")
+        ops.append((m.group("op"), args[0], args[1]))
+    if not ops:
+        raise SystemExit("no aot_*_run calls in aot_model_run()")
+    return ops
+
+
+def build(ops, inplace_names):
+    """Tensors by producing op, with lifetimes; each op's input tensor (None if external)."""
+    names = [op for op, _, _ in ops]
+    tensors, writer, inputs = {}, {}, []
+    for i, (op, src, dst) in enumerate(ops):
+        t_in = None
+        m = ARENA_RE.match(src)
+        if m:
+            off = m.group("off")
+            # Planned form names the producer; raw generator output is resolved by the last writer of that offset
+            producer = next((n for n in names if macro(n) == off), None) or writer.get(off)
+            if producer is None or producer not in tensors:
+                raise SystemExit(f"aot_{op}_run reads {src}, which no earlier operator writes")
+            t_in = tensors[producer]
+            t_in.last = i
+        inputs.append(t_in)
+        kind, size, declared = op_info(op)
+        m = ARENA_RE.match(dst)
+        if m:
+            t = Tensor(op, size)
+            t.kind = kind
+            t.first = t.last = i
+            # A header that declares 0 wins over --inplace: its kernel is known to be unsafe
+            t.inplace = declared if declared is not None else op in inplace_names or kind in inplace_names
+            tensors[op] = t
+            writer[m.group("off")] = op
+    # In-place: the output takes the input's block when the input dies at this op
+    for i, (op, _, _) in enumerate(ops):
+        t, t_in = tensors.get(op), inputs[i]
+        if t and t_in and t.inplace and t_in.last == i and t.size <= root(t_in).size:
+            t.alias = root(t_in)
+            t.alias.last = max(t.alias.last, t.last)
+    return tensors, inputs
+
+
+def root(t):
+    while t.alias:
+        t = t.alias
+    return t
+
+
+def place(blocks, order, align):
+    """Lowest aligned offset for each block, clear of those already placed that overlap in time."""
+    placed = []
+    for b in order:
+        off = 0
+        for o in sorted((p for p in placed if p.first <= b.last and b.first <= p.last), key=lambda p: p.offset):
+            if off + b.size <= o.offset:
+                break
+            off = max(off, -(-(o.offset + o.size) // align) * align)
+        b.offset = off
+        placed.append(b)
+    return max((b.offset + b.size for b in blocks), default=0)
+
+
+def plan(tensors, align):
+    blocks = [t for t in tensors.values() if not t.alias]
+    heuristics = {
+        "size": sorted(blocks, key=lambda b: (-b.size, b.first)),
+        "order": sorted(blocks, key=lambda b: b.first),
+    }
+    best = None
+    for name, order in heuristics.items():
+        arena = place(blocks, order, align)
+        if best is None or arena < best[1]:
+            best = (name, arena, {id(b): b.offset for b in blocks})
+    name, arena, offsets = best
+    for b in blocks:
+        b.offset = offsets[id(b)]
+    for t in tensors.values():
+        t.offset = root(t).offset
+    return name, arena
+
+
+def header(ops, tensors, arena, heuristic):
+    lines = [
+        "#ifndef aot_model_plan_h",
+        "#define aot_model_plan_h",
+        "",
+        "// Activation arena of aot_model.c, generated by tools/aot_plan.py from the",
+        "// operator list and tensor lifetimes (heuristic: greedy by %s). Do not edit;" % heuristic,
+        "// rerun the tool after regenerating the model.",
+        "",
+        f"#define AOT_PLAN_ARENA_SIZE {arena}",
+        "",
+        "// Offset of each operator's output: bytes, and the run steps (operators in",
+        "// call order, from 0) it is live over",
+    ]
+    width = max(len(macro(op)) for op in tensors) + 1
+    for op, _, _ in ops:
+        t = tensors.get(op)
+        if not t:
+            continue
+        note = f"{t.size} bytes, steps {t.first}-{t.last}"
+        if t.alias:
+            note += f", in place over {t.alias.op}"
+        lines.append(f"#define {macro(op):<{width}}{t.offset:<6}// {note}")
+    lines += ["", "#endif // aot_model_plan_h", ""]
+    return "\n".join(lines)
+
+
+def apply(text, ops, tensors, inputs):
+    """aot_model.c with the planned arena size and a macro for every arena pointer."""
+    text = BUFFER_RE.sub("model_buffer[AOT_PLAN_ARENA_SIZE]", text, count=1)
+    if '#include "aot_model_plan.h"' not in text:
+        text = text.replace('#include "aot_model.h"\n', '#include "aot_model.h"\n#include "aot_model_plan.h"\n', 1)
+    run_at = text.index("int32_t aot_model_run(")
+    head, run = text[:run_at], text[run_at:]
+    for (op, src, dst), t_in in zip(ops, inputs):
+        new_src = f"(int8_t *)(buffer + {macro(t_in.op)})" if t_in else src
+        new_dst = f"(int8_t *)(buffer + {macro(op)})" if op in tensors else dst
+        run = run.replace(f"aot_{op}_run({src}, {dst})", f"aot_{op}_run({new_src}, {new_dst})", 1)
+    return head + run
+
+
+def main(argv=None):
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--model", default=AOT / "src" / "aot_model.c", help="generated aot_model.c")
+    ap.add_argument("--out", default=AOT / "includes-api" / "aot_model_plan.h", help="plan header to write")
+    ap.add_argument("--align", type=int, default=16, help="offset alignment in bytes")
+    ap.add_argument("--inplace", nargs="+", default=[], metavar="OP", help="undeclared operators (or types) allowed in place")
+    ap.add_argument("--apply", action="store_true", help="also rewrite aot_model.c to use the plan")
+    ap.add_argument("--dry-run", action="store_true", help="print the plan, write nothing")
+    ap.add_argument("--check", action="store_true", help="only report whether the header is up to date")
+    args = ap.parse_args(argv)
+
+    model = Path(args.model)
+    text = model.read_text()
+    ops = parse_model(text)
+    tensors, inputs = build(ops, set(args.inplace))
+    heuristic, arena = plan(tensors, args.align)
+    old = BUFFER_RE.search(text)
+
+    print(f"{'op':<22} {'type':<18} {'bytes':>6} {'steps':>7} {'offset':>6}")
+    for op, _, _ in ops:
+        t = tensors.get(op)
+        if t:
+            live = f"{t.first}-{t.last}"
+            extra = f"  (in place over {t.alias.op})" if t.alias else ""
+            print(f"{op:<22} {t.kind:<18} {t.size:>6} {live:>7} {t.offset:>6}{extra}")
+        else:
+            print(f"{op:<22} {op_info(op)[0]:<18} {'-':>6} {'-':>7} {'output':>6}")
+    peak = max(sum(t.size for t in tensors.values() if not t.alias and t.first <= i <= t.last) for i in range(len(ops)))
+    print(f"arena={arena} bytes (greedy by {heuristic}), live peak={peak}, model_buffer[{old.group('size')}]")
+
+    out = Path(args.out)
+    hdr = header(ops, tensors, arena, heuristic)
+    if args.check:
+        if not out.exists() or out.read_text() != hdr:
+            print(f"{out.relative_to(REPO)} is out of date; run tools/aot_plan.py", file=sys.stderr)
+            return 1
+        return 0
+    if args.dry_run:
+        return 0
+    out.write_text(hdr)
+    if args.apply:
+        model.write_text(apply(text, ops, tensors, inputs))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,402 @@
+#!/usr/bin/env python3
+"""Generate the CMSIS-NN wrapper layer from the library's public headers.
+
+Parses the prototypes in arm_nnfunctions.h (every public kernel, the
+arm_*_get_buffer_size family included) and the helpers of HELPERS in
+arm_nnsupportfunctions.h, and rewrites the GENERATED regions of:
+
+    src/kernel_timing_wrap.c   __real_/__wrap_ pairs, one KERNEL_MEASURE / HELPER_MEASURE each
+    src/kernel_timing_wrap.h   KERNEL_LIST and KERNEL_HELPER_LIST (list position = trace id)
+    makefile_wrapper_call.mk   WRAP_KERNELS and WRAP_HELPERS (-Wl,--wrap= list)
+
+so the three stay in sync and every kernel gets the same instrumentation.
+Kernels returning something other than arm_cmsis_nn_status are logged as
+successful and return the real value. Operand shapes come from SHAPES; kernels
+without an entry log no shape record. A call whose output pointer equals one of
+its input pointers runs in place and is never re-run (see in_place()). Edit
+this file, not the regions.
+
+    python3 tools/gen_wrappers.py
+    python3 tools/gen_wrappers.py --check    # exit 1 if the checked-in files are stale
+"""
+
+import argparse
+import re
+import sys
+from pathlib import Path
+
+REPO = Path(__file__).resolve().parent.parent
+INCLUDE = REPO / "modules" / "ns-cmsis-nn" / "Include"
+WRAP_C = REPO / "src" / "kernel_timing_wrap.c"
+WRAP_H = REPO / "src" / "kernel_timing_wrap.h"
+WRAP_MK = REPO / "makefile_wrapper_call.mk"
+
+COLUMNS = 120
+
+# Internal helpers timed per parent call with KERNEL_HELPERS=1 (arm_nnsupportfunctions.h). Only
+# functions with external linkage can be wrapped: arm_nn_requantize is static inline and the MVE
+# im2col is inlined into the convolutions.
+HELPERS = (
+    "arm_nn_depthwise_conv_nt_t_s8",
+    "arm_nn_mat_mul_core_1x_s8",
+    "arm_nn_mat_mul_core_4x_s8",
+    "arm_nn_mat_mult_nt_t_s8",
+    "arm_nn_vec_mat_mult_t_s8",
+)
+
+# Public functions left unwrapped
+SKIP = ()
+
+
+def conv(kind, params, elem, bits, bias):
+    return (
+        f"shape_conv(&shape, {kind}, input_dims, filter_dims, output_dims, &{params}->stride, "
+        f"&{params}->padding, &{params}->dilation, sizeof({elem}), {bits}, {bias})"
+    )
+
+
+def fc(elem, bits, bias):
+    return f"shape_fc(&shape, input_dims, filter_dims, output_dims, sizeof({elem}), {bits}, sizeof({bias}))"
+
+
+def flat(count, operands, elem_in, elem_out, mul=0):
+    return f"shape_flat(&shape, {count}, {operands}, sizeof({elem_in}), sizeof({elem_out}), {mul})"
+
+
+S16_BIAS = "bias_data && bias_data->is_int32_bias ? sizeof(int32_t) : sizeof(int64_t)"
+
+# Operand shape statement per kernel, in terms of the prototype's parameter names (see the
+# shape_* helpers in kernel_timing_wrap.c)
+SHAPES = {
+    "arm_add_s16": "shape_binary(&shape, input1_dims, input2_dims, output_dims, sizeof(int16_t), 0)",
+    "arm_add_s8": "shape_binary(&shape, input1_dims, input2_dims, output_dims, sizeof(int8_t), 0)",
+    "arm_avgpool_s16": "shape_pool(&shape, pool_params, input_dims, filter_dims, output_dims, sizeof(int16_t))",
+    "arm_avgpool_s8": "shape_pool(&shape, pool_params, input_dims, filter_dims, output_dims, sizeof(int8_t))",
+    "arm_batch_matmul_s16": "shape_bmm(&shape, input_lhs_dims, input_rhs_dims, output_dims, sizeof(int16_t))",
+    "arm_batch_matmul_s8": "shape_bmm(&shape, input_lhs_dims, input_rhs_dims, output_dims, sizeof(int8_t))",
+    "arm_convolve_1_x_n_s4": conv("SHAPE_CONV", "conv_params", "int8_t", 4, "sizeof(int32_t)"),
+    "arm_convolve_1_x_n_s8": conv("SHAPE_CONV", "conv_params", "int8_t", 8, "sizeof(int32_t)"),
+    "arm_convolve_1x1_s4": conv("SHAPE_CONV", "conv_params", "int8_t", 4, "sizeof(int32_t)"),
+    "arm_convolve_1x1_s4_fast": conv("SHAPE_CONV", "conv_params", "int8_t", 4, "sizeof(int32_t)"),
+    "arm_convolve_1x1_s8": conv("SHAPE_CONV", "conv_params", "int8_t", 8, "sizeof(int32_t)"),
+    "arm_convolve_1x1_s8_fast": conv("SHAPE_CONV", "conv_params", "int8_t", 8, "sizeof(int32_t)"),
+    "arm_convolve_s16": conv("SHAPE_CONV", "conv_params", "int16_t", 8, S16_BIAS),
+    "arm_convolve_s4": conv("SHAPE_CONV", "conv_params", "int8_t", 4, "sizeof(int32_t)"),
+    "arm_convolve_s8": conv("SHAPE_CONV", "conv_params", "int8_t", 8, "sizeof(int32_t)"),
+    "arm_convolve_weight_sum": "shape_weight_sum(&shape, filter_dims->n, filter_dims->h * filter_dims->w * filter_dims->c, 8)",
+    "arm_convolve_weight_sum_s4": "shape_weight_sum(&shape, filter_dims->n, filter_dims->h * filter_dims->w * filter_dims->c, 4)",
+    "arm_convolve_wrapper_s16": conv("SHAPE_CONV", "conv_params", "int16_t", 8, S16_BIAS),
+    "arm_convolve_wrapper_s4": conv("SHAPE_CONV", "conv_params", "int8_t", 4, "sizeof(int32_t)"),
+    "arm_convolve_wrapper_s8": conv("SHAPE_CONV", "conv_params", "int8_t", 8, "sizeof(int32_t)"),
+    "arm_depthwise_conv_3x3_s8": conv("SHAPE_DEPTHWISE", "dw_conv_params", "int8_t", 8, "sizeof(int32_t)"),
+    "arm_depthwise_conv_fast_s16": conv("SHAPE_DEPTHWISE", "dw_conv_params", "int16_t", 8, "sizeof(int64_t)"),
+    "arm_depthwise_conv_s16": conv("SHAPE_DEPTHWISE", "dw_conv_params", "int16_t", 8, "sizeof(int64_t)"),
+    "arm_depthwise_conv_s4": conv("SHAPE_DEPTHWISE", "dw_conv_params", "int8_t", 4, "sizeof(int32_t)"),
+    "arm_depthwise_conv_s4_opt": conv("SHAPE_DEPTHWISE", "dw_conv_params", "int8_t", 4, "sizeof(int32_t)"),
+    "arm_depthwise_conv_s8": conv("SHAPE_DEPTHWISE", "dw_conv_params", "int8_t", 8, "sizeof(int32_t)"),
+    "arm_depthwise_conv_s8_opt": conv("SHAPE_DEPTHWISE", "dw_conv_params", "int8_t", 8, "sizeof(int32_t)"),
+    "arm_depthwise_conv_wrapper_s16": conv("SHAPE_DEPTHWISE", "dw_conv_params", "int16_t", 8, "sizeof(int64_t)"),
+    "arm_depthwise_conv_wrapper_s4": conv("SHAPE_DEPTHWISE", "dw_conv_params", "int8_t", 4, "sizeof(int32_t)"),
+    "arm_depthwise_conv_wrapper_s8": conv("SHAPE_DEPTHWISE", "dw_conv_params", "int8_t", 8, "sizeof(int32_t)"),
+    "arm_depthwise_convolve_weight_sum": "shape_weight_sum(&shape, filter_dims->c, filter_dims->h * filter_dims->w, 8)",
+    "arm_depthwise_weight_sum_s4": "shape_weight_sum(&shape, filter_dims->c, filter_dims->h * filter_dims->w, 4)",
+    "arm_elementwise_add_s16": flat("block_size", 2, "int16_t", "int16_t"),
+    "arm_elementwise_add_s8": flat("block_size", 2, "int8_t", "int8_t"),
+    "arm_elementwise_mul_s16": flat("block_size", 2, "int16_t", "int16_t", 1),
+    "arm_elementwise_mul_s8": flat("block_size", 2, "int8_t", "int8_t", 1),
+    "arm_fully_connected_per_channel_s8": fc("int8_t", 8, "int32_t"),
+    "arm_fully_connected_s16": fc("int16_t", 8, "int64_t"),
+    "arm_fully_connected_s4": fc("int8_t", 4, "int32_t"),
+    "arm_fully_connected_s8": fc("int8_t", 8, "int32_t"),
+    "arm_fully_connected_wrapper_s8": fc("int8_t", 8, "int32_t"),
+    "arm_hard_swish_compat_s16": flat("output_size", 1, "int16_t", "int16_t"),
+    "arm_hard_swish_compat_s8": flat("output_size", 1, "int8_t", "int8_t"),
+    "arm_hard_swish_precise_s16": flat("output_size", 1, "int16_t", "int16_t"),
+    "arm_hard_swish_precise_s8": flat("output_size", 1, "int8_t", "int8_t"),
+    "arm_leaky_relu_s8": flat("output_size", 1, "int8_t", "int8_t"),
+    "arm_max_pool_s16": "shape_pool(&shape, pool_params, input_dims, filter_dims, output_dims, sizeof(int16_t))",
+    "arm_max_pool_s8": "shape_pool(&shape, pool_params, input_dims, filter_dims, output_dims, sizeof(int8_t))",
+    "arm_maximum_s16": "shape_binary(&shape, input_1_dims, input_2_dims, output_dims, sizeof(int16_t), 0)",
+    "arm_maximum_s8": "shape_binary(&shape, input_1_dims, input_2_dims, output_dims, sizeof(int8_t), 0)",
+    "arm_mean_s16": "shape_unary(&shape, input_dims, output_dims, sizeof(int16_t))",
+    "arm_mean_s8": "shape_unary(&shape, input_dims, output_dims, sizeof(int8_t))",
+    "arm_minimum_s16": "shape_binary(&shape, input_1_dims, input_2_dims, output_dims, sizeof(int16_t), 0)",
+    "arm_minimum_s8": "shape_binary(&shape, input_1_dims, input_2_dims, output_dims, sizeof(int8_t), 0)",
+    "arm_mul_s16": "shape_binary(&shape, input1_dims, input2_dims, output_dims, sizeof(int16_t), 1)",
+    "arm_mul_s8": "shape_binary(&shape, input1_dims, input2_dims, output_dims, sizeof(int8_t), 1)",
+    "arm_pad_s16": "shape_pad(&shape, input_size, pre_pad, post_pad, sizeof(int16_t))",
+    "arm_pad_s8": "shape_pad(&shape, input_size, pre_pad, post_pad, sizeof(int8_t))",
+    "arm_quantize_f32_s16": flat("size", 1, "float", "int16_t"),
+    "arm_quantize_f32_s8": flat("size", 1, "float", "int8_t"),
+    "arm_reduce_max_s16": "shape_unary(&shape, input_dims, output_dims, sizeof(int16_t))",
+    "arm_reduce_max_s8": "shape_unary(&shape, input_dims, output_dims, sizeof(int8_t))",
+    "arm_relu_s16": flat("output_size", 1, "int16_t", "int16_t"),
+    "arm_relu_s8": flat("output_size", 1, "int8_t", "int8_t"),
+    "arm_requantize_s16_s16": flat("size", 1, "int16_t", "int16_t"),
+    "arm_requantize_s8_s8": flat("size", 1, "int8_t", "int8_t"),
+    "arm_softmax_s16": flat("num_rows * row_size", 1, "int16_t", "int16_t"),
+    "arm_softmax_s8": flat("num_rows * row_size", 1, "int8_t", "int8_t"),
+    "arm_softmax_s8_s16": flat("num_rows * row_size", 1, "int8_t", "int16_t"),
+    "arm_strided_slice_s8": "shape_slice(&shape, input_dims, output_dims)",
+    "arm_transpose_conv_s8": conv("SHAPE_TRANSPOSE_CONV", "transpose_conv_params", "int8_t", 8, "sizeof(int32_t)"),
+    "arm_transpose_conv_wrapper_s8": conv(
+        "SHAPE_TRANSPOSE_CONV", "transpose_conv_params", "int8_t", 8, "sizeof(int32_t)"
+    ),
+    "arm_transpose_s16": "shape_unary(&shape, input_dims, output_dims, sizeof(int16_t))",
+    "arm_transpose_s8": "shape_unary(&shape, input_dims, output_dims, sizeof(int8_t))",
+    "arm_vector_sum_s8": "shape_weight_sum(&shape, vector_rows, vector_cols, 8)",
+}
+
+PROTO_RE = re.compile(r"(?:^|(?<=[;{}]))\s*((?:const\s+)?\w+(?:\s*\*)*)\s*\b(arm_\w+)\s*\(([^;{}()]*)\)\s*;", re.S)
+
+
+# --------------------------------------------------------------------------- #
+# Header parsing
+# --------------------------------------------------------------------------- #
+
+
+def strip_c(text):
+    """Drop comments, preprocessor lines and function bodies (static inline helpers), keep declarations."""
+    text = re.sub(r"/\*.*?\*/", " ", text, flags=re.S)
+    text = re.sub(r"//[^\n]*", "", text)
+    text = re.sub(r"^\s*#[^\n]*(?:\\\n[^\n]*)*", "", text, flags=re.M)
+    out, i = "", 0
+    while i < len(text):
+        if text[i] == "{" and out.rstrip().endswith(")"):
+            depth = 0
+            for j in range(i, len(text)):
+                depth += {"{": 1, "}": -1}.get(text[j], 0)
+                if depth == 0:
+                    break
+            out += ";"
+            i = j + 1
+            continue
+        out += text[i]
+        i += 1
+    return out
+
+
+def split_args(text):
+    """Split at top-level commas."""
+    args, depth, cur = [], 0, ""
+    for ch in text:
+        if ch in "([":
+            depth += 1
+        elif ch in ")]":
+            depth -= 1
+        if ch == "," and depth == 0:
+            args.append(cur.strip())
+            cur = ""
+        else:
+            cur += ch
+    if cur.strip():
+        args.append(cur.strip())
+    return args
+
+
+def parse_prototypes(header):
+    """{name: (return type, [(param type, param name)])} for the arm_* declarations in header."""
+    header = Path(header)
+    if not header.is_file():
+        shown = header.relative_to(REPO) if header.is_relative_to(REPO) else header
+        raise SystemExit(
+            f"{shown}: no such header; the CMSIS-NN sources live in the ns-cmsis-nn submodule:\n"
+            f"    git submodule update --init modules/ns-cmsis-nn"
+        )
+    protos = {}
+    for m in PROTO_RE.finditer(strip_c(header.read_text())):
+        ret, name, params = " ".join(m.group(1).split()), m.group(2), " ".join(m.group(3).split())
+        parsed = []
+        for p in split_args(params):
+            if p == "void":
+                continue
+            pm = re.match(r"(.*?)\s*\b(\w+)$", p)
+            if not pm:
+                raise SystemExit(f"{header}: cannot parse parameter '{p}' of {name}")
+            parsed.append((pm.group(1), pm.group(2)))
+        protos[name] = (ret, parsed)
+    return protos
+
+
+# --------------------------------------------------------------------------- #
+# C emission (.clang-format: LLVM, 2-space indent, AlwaysBreak, 120 columns)
+# --------------------------------------------------------------------------- #
+
+
+def pack(indent, items, tail):
+    """items joined by ", " and filled greedily into lines at indent; tail follows the last item."""
+    lines, cur = [], ""
+    for i, item in enumerate(items):
+        piece = item + ("," if i < len(items) - 1 else tail)
+        if cur and len(indent + cur + " " + piece) > COLUMNS:
+            lines.append(indent + cur)
+            cur = piece
+        else:
+            cur = f"{cur} {piece}" if cur else piece
+    lines.append(indent + cur)
+    return lines
+
+
+def call(indent, head, args, tail):
+    """head(args)tail on one line, or broken after the parenthesis with the arguments packed below."""
+    one = f"{indent}{head}({', '.join(args)}){tail}"
+    if len(one) <= COLUMNS:
+        return [one]
+    return [f"{indent}{head}("] + pack(indent + "    ", args, ")" + tail)
+
+
+def signature(ret, name, params, tail):
+    """Function declarator; the return type goes on its own line when that keeps the parameters on one."""
+    lines = call("", declaration(ret, name), params, tail)
+    own = f"{name}({', '.join(params)}){tail}"
+    if len(lines) > 1 and len(own) <= COLUMNS:
+        return [ret, own]
+    return lines
+
+
+def declaration(type_, name):
+    return f"{type_}{name}" if type_.endswith("*") else f"{type_} {name}"
+
+
+def measure(macro, leading, head, args, status=None):
+    """macro(leading..., head(args)); the call on its own line(s) when it does not fit.
+
+    With status, the call is the left operand of (head(args), status).
+    """
+    inner_tail = f", {status})" if status else ""
+    one = f"  {macro}({', '.join(leading)}, {head}({', '.join(args)}){inner_tail});"
+    if len(one) <= COLUMNS:
+        return [one]
+    packed = f"      {', '.join(leading)}, {head}({', '.join(args)}){inner_tail});"
+    if len(packed) <= COLUMNS:
+        return [f"  {macro}(", packed]
+    lines = [f"  {macro}(", f"      {', '.join(leading)},"]
+    single = call("      ", head, args, inner_tail + ");")
+    if not status or len(single) == 1:
+        return lines + single
+    return lines + call("      ", head, args, ",") + [f"       {status}));"]
+
+
+DATA_PTR = re.compile(r"^(const )?(u?int(?:8|16|32|64)_t|float) \*(?: ?const)?$")
+
+
+def in_place(params):
+    """KERNEL_MEASURE's inplace argument: output == input for every data output and input of its type."""
+    data = [(DATA_PTR.match(t), n) for t, n in params if DATA_PTR.match(t)]
+    outs = [(m.group(2), n) for m, n in data if not m.group(1) and "out" in n]
+    ins = [(m.group(2), n) for m, n in data if m.group(1) and "input" in n]
+    tests = [f"{o} == {i}" for ot, o in outs for it, i in ins if ot == it]
+    return " || ".join(tests) if tests else "false"
+
+
+def wrapper(name, ret, params, shape, helper=False):
+    """__real_ declaration and __wrap_ definition for one function."""
+    decls = [declaration(t, n) for t, n in params]
+    args = [n for _, n in params]
+    real = "__real_" + name
+    out = [f"// {name}"]
+    out += signature(ret, real, decls, ";")
+    out.append("")
+    out += signature(ret, "__wrap_" + name, decls, "")
+    out.append("{")
+    if helper:
+        var = "rc" if ret == "arm_cmsis_nn_status" else "ret"
+        out.append(f"  {declaration(ret, var)};")
+        out += measure("HELPER_MEASURE", [f"KERNEL_HELPER_{name}", var], real, args)
+        out.append(f"  return {var};")
+        return out + ["}"]
+    if shape:
+        out.append("  kernel_shape_record_t shape;")
+        out += call("  ", shape[: shape.index("(")], split_args(shape[shape.index("(") + 1 : -1]), ";")
+    leading = [name, "&shape" if shape else "NULL", in_place(params), "rc"]
+    if ret == "arm_cmsis_nn_status":
+        out.append("  arm_cmsis_nn_status rc;")
+        out += measure("KERNEL_MEASURE", leading, real, args)
+        out.append("  return rc;")
+    elif ret == "void":
+        # Logged as successful
+        out.append("  arm_cmsis_nn_status rc;")
+        out += measure("KERNEL_MEASURE", leading, "(" + real, args, "ARM_CMSIS_NN_SUCCESS")
+    else:
+        # Logged as successful; the real result is returned
+        out.append(f"  {declaration(ret, 'ret')};")
+        out.append("  arm_cmsis_nn_status rc;")
+        out += measure("KERNEL_MEASURE", leading, "(ret = " + real, args, "ARM_CMSIS_NN_SUCCESS")
+        out.append("  return ret;")
+    return out + ["}"]
+
+
+# --------------------------------------------------------------------------- #
+# Regions
+# --------------------------------------------------------------------------- #
+
+
+def replace_region(text, name, body, comment, path):
+    begin, end = f"{comment} BEGIN GENERATED {name}\n", f"{comment} END GENERATED {name}\n"
+    if text.count(begin) != 1 or text.count(end) != 1:
+        raise SystemExit(f"{path}: expected exactly one '{begin.strip()}' ... '{end.strip()}' region")
+    head, rest = text.split(begin)
+    _, tail = rest.split(end)
+    return head + begin + body + end + tail
+
+
+def c_list(macro, names):
+    return f"#define {macro} \\\n" + " \\\n".join(f"  X({n})" for n in names) + "\n"
+
+
+def mk_list(var, names):
+    return f"{var} := \\\n" + " \\\n".join(f"\t{n}" for n in names) + "\n"
+
+
+def generate(kernels, helpers):
+    """{path: new text} for the three generated files."""
+    c_text = WRAP_C.read_text()
+    body = "\n".join("\n".join(wrapper(n, *kernels[n], SHAPES.get(n))) + "\n" for n in kernels)
+    c_text = replace_region(c_text, "kernel wrappers", body, "//", WRAP_C)
+    body = "\n".join("\n".join(wrapper(n, *helpers[n], None, helper=True)) + "\n" for n in helpers)
+    c_text = replace_region(c_text, "helper wrappers", body, "//", WRAP_C)
+
+    h_text = replace_region(WRAP_H.read_text(), "kernel list", c_list("KERNEL_LIST", kernels), "//", WRAP_H)
+    h_text = replace_region(h_text, "helper list", c_list("KERNEL_HELPER_LIST", helpers), "//", WRAP_H)
+
+    mk_text = replace_region(WRAP_MK.read_text(), "kernel list", mk_list("WRAP_KERNELS", kernels), "#", WRAP_MK)
+    mk_text = replace_region(mk_text, "helper list", mk_list("WRAP_HELPERS", helpers), "#", WRAP_MK)
+    return {WRAP_C: c_text, WRAP_H: h_text, WRAP_MK: mk_text}
+
+
+def main(argv=None):
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--nnfunctions", default=INCLUDE / "arm_nnfunctions.h", help="public CMSIS-NN header")
+    ap.add_argument("--support", default=INCLUDE / "arm_nnsupportfunctions.h", help="CMSIS-NN support header")
+    ap.add_argument("--check", action="store_true", help="only report whether the generated files are up to date")
+    args = ap.parse_args(argv)
+
+    public = parse_prototypes(args.nnfunctions)
+    kernels = {n: public[n] for n in sorted(public) if n not in SKIP}
+    support = parse_prototypes(args.support)
+    missing = [n for n in HELPERS if n not in support]
+    if missing:
+        raise SystemExit(f"{args.support}: no prototype for {', '.join(missing)}")
+    helpers = {n: support[n] for n in sorted(HELPERS)}
+    unused = sorted(set(SHAPES) - set(kernels))
+    if unused:
+        print(f"warning: SHAPES entries without a kernel: {', '.join(unused)}", file=sys.stderr)
+    if len(kernels) + len(helpers) > 255:
+        raise SystemExit("more than 255 kernels and helpers; trace records carry an 8-bit id")
+
+    stale = []
+    for path, text in generate(kernels, helpers).items():
+        if path.read_text() != text:
+            stale.append(path)
+            if not args.check:
+                path.write_text(text)
+    if args.check:
+        for path in stale:
+            print(f"{path.relative_to(REPO)} is out of date; run tools/gen_wrappers.py", file=sys.stderr)
+        return 1 if stale else 0
+    print(f"{len(kernels)} kernels, {len(helpers)} helpers; updated {len(stale)} file(s)")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""Run the host build's test selection as parallel shards.
+
+Starts --jobs copies of host/build/main_host, shard k of n each
+(test_library_shard()), with its own log and result store
+(RESULT_STORE_FILE) under --out. When all are done it writes the logs back to
+back, in shard order, to <out>/host.log, which perf_db.py and trace_decode.py
+read like a device capture, and prints each shard's [SUITE] line. Exits
+non-zero if any shard had a test that did not pass.
+
+    make -C host check JOBS=8
+    python3 tools/host_shards.py --jobs 4 --select '@convolution'
+    python3 tools/result_store.py host/build/shards/result_store.*.bin
+
+With --qemu CMD each shard is instead a QEMU instance running the Cortex-M55
+image (qemu/Makefile passes the command, without the plugin's out= and the
+program arguments). The plugin writes <out>/insns.K.log per shard and these
+are merged, in shard order, into <out>/insns.log for tools/qemu_insns.py.
+
+    make -C qemu check JOBS=8
+"""
+
+import argparse
+import os
+import re
+import shlex
+import subprocess
+import sys
+from pathlib import Path
+
+REPO = Path(__file__).resolve().parent.parent
+SUITE_RE = re.compile(r"^\[SUITE\] .*$", re.M)
+
+
+def main(argv=None):
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--binary", default=REPO / "host" / "build" / "main_host", help="host test runner")
+    ap.add_argument("--jobs", type=int, default=os.cpu_count() or 1, help="shards run in parallel")
+    ap.add_argument("--select", help="test_library_select() expression (default: the built-in TEST_SELECT)")
+    ap.add_argument("--qemu", help="QEMU command line ending in the kernel_insns plugin option (qemu/Makefile)")
+    ap.add_argument("--out", default=REPO / "host" / "build" / "shards", help="directory for logs and stores")
+    args = ap.parse_args(argv)
+
+    out = Path(args.out)
+    out.mkdir(parents=True, exist_ok=True)
+    n = max(args.jobs, 1)
+    procs = []
+    for k in range(n):
+        prog = ["--shard", f"{k}/{n}"] + (["--select", args.select] if args.select else [])
+        if args.qemu:
+            # The program arguments reach main() through the semihosting command line
+            cmd = shlex.split(args.qemu)
+            cmd[-1] += f",out={out / f'insns.{k}.log'}"
+            cmd += ["-append", shlex.join(prog)]
+        else:
+            cmd = [str(args.binary)] + prog
+        env = dict(os.environ, RESULT_STORE_FILE=str(out / f"result_store.{k}.bin"))
+        log = open(out / f"shard_{k}.log", "w")
+        procs.append((subprocess.Popen(cmd, stdout=log, stderr=subprocess.STDOUT, env=env), log))
+
+    failed = 0
+    with open(out / "host.log", "w") as merged:
+        for k, (proc, log) in enumerate(procs):
+            rc = proc.wait()
+            log.close()
+            text = (out / f"shard_{k}.log").read_text(errors="replace")
+            merged.write(text)
+            suite = SUITE_RE.findall(text)
+            print(f"[SHARD {k}/{n}] exit={rc} {suite[-1] if suite else '(no [SUITE] line)'}")
+            failed |= rc != 0
+    if args.qemu:
+        with open(out / "insns.log", "w") as merged:
+            for k in range(n):
+                path = out / f"insns.{k}.log"
+                merged.write(path.read_text() if path.exists() else "")
+        print(f"instruction counts: {out}/insns.log")
+    print(f"logs: {out}/shard_*.log, merged: {out}/host.log")
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
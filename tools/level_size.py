@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+"""Flash/RAM cost of each compile-time instrumentation level.
+
+Builds the firmware once per KERNEL_TIMING_LEVEL (makefile_wrapper_call.mk) and
+prints the size of src/kernel_timing_wrap.o and of the linked image, plus the
+growth over the first level built (NONE by default). Per-call latency is
+measured on the device: build with KERNEL_LEVEL_BENCH=1 and read the
+[LEVEL_BENCH] lines.
+
+    python3 tools/level_size.py
+    python3 tools/level_size.py --levels NONE CYCLES -- BOARD=apollo510_evb
+"""
+
+import argparse
+import subprocess
+import sys
+from pathlib import Path
+
+REPO = Path(__file__).resolve().parent.parent
+LEVELS = ("NONE", "COUNT_ONLY", "CYCLES", "DWT", "FULL_PMU")
+
+
+def size(tool, path):
+    """(text, data, bss) of an object or image, from binutils size."""
+    out = subprocess.run([tool, str(path)], check=True, capture_output=True, text=True).stdout
+    text, data, bss = out.splitlines()[1].split()[:3]
+    return int(text), int(data), int(bss)
+
+
+def build(level, make_args):
+    subprocess.run(["make", "clean", *make_args], cwd=REPO, check=True, stdout=subprocess.DEVNULL)
+    subprocess.run(
+        ["make", "-j", f"KERNEL_TIMING_LEVEL={level}", *make_args], cwd=REPO, check=True, stdout=subprocess.DEVNULL
+    )
+
+
+def main(argv=None):
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--levels", nargs="+", choices=LEVELS, default=list(LEVELS))
+    ap.add_argument("--bindir", default="build/apollo5b_evb/arm-none-eabi", help="make's BINDIR, relative to the repo")
+    ap.add_argument("--size", default="arm-none-eabi-size", help="binutils size for the target")
+    ap.add_argument("make_args", nargs="*", help="extra make variables, after --")
+    args = ap.parse_args(argv)
+
+    bindir = REPO / args.bindir
+    print(
+        f"{'level':<11} {'obj text':>9} {'obj data':>9} {'obj bss':>8} {'axf text':>9} {'axf ram':>8} "
+        f"{'+flash':>7} {'+ram':>6}"
+    )
+    base = None
+    for level in args.levels:
+        build(level, args.make_args)
+        obj = size(args.size, bindir / "src" / "kernel_timing_wrap.o")
+        image = size(args.size, bindir / "main.axf")
+        flash, ram = image[0] + image[1], image[1] + image[2]
+        if base is None:
+            base = (flash, ram)
+        print(
+            f"{level:<11} {obj[0]:>9} {obj[1]:>9} {obj[2]:>8} {image[0]:>9} {ram:>8} "
+            f"{flash - base[0]:>7} {ram - base[1]:>6}"
+        )
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,600 @@
+#!/usr/bin/env python3
+"""Local results database and regression gate for kernel timing logs.
+
+Ingests SWO/UART captures from the test harness (wrapper text lines, [KERNEL]
+lines or [TRACE] blocks), keys every sample by test name and kernel, and stores
+runs in SQLite. `gate` compares two runs per (test, kernel, metric) with a
+one-sided Mann-Whitney U test plus a minimum relative change, and exits non-zero
+with a per-kernel report when something regressed. `changepoints` looks for
+level shifts in a metric across the recorded history. `roofline` places each
+kernel call against the MVE compute peak and a memory bandwidth from the
+operand shapes the wrappers record. CMSIS-NN helper aggregates are stored under
+"<parent>/<helper>" as helper_calls and cycles, [COUNT] call counts as calls,
+[STATS] aggregates as stats_* under the dump label, and the per-test phase
+breakdown ([TEST_TIME], [SUITE]) as test_*/suite_* under the kernel "*".
+
+    python3 tools/perf_db.py ingest --label main-1234 swo.log
+    JLinkSWOViewerCL ... | python3 tools/perf_db.py ingest --label wip -
+    python3 tools/perf_db.py gate --baseline main-1234 --candidate wip
+    python3 tools/perf_db.py changepoints --metric cycles
+    python3 tools/perf_db.py roofline --run wip --bandwidth 4
+"""
+
+import argparse
+import math
+import re
+import sqlite3
+import statistics
+import sys
+from datetime import datetime, timezone
+from pathlib import Path
+
+import trace_decode
+
+DEFAULT_DB = "perf_results.sqlite"
+
+# Metrics compared by `gate` unless --metric is given
+GATED_METRICS = ("cycles", "instructions", "INST_RETIRED", "MVE_INST_RETIRED")
+
+# Wrapper text labels / trace record fields -> stored metric name
+TEXT_METRICS = {
+    "Time_us": "time_us",
+    "DWT_cycles": "cycles",
+    "DWT_instructions": "instructions",
+    "DWT_cpi": "cpi",
+    "DWT_exceptions": "exceptions",
+    "DWT_sleep": "sleep",
+    "DWT_lsu": "lsu",
+    "DWT_fold": "fold",
+}
+TRACE_METRICS = {
+    "cyccnt": "cycles",
+    "cpicnt": "cpi",
+    "exccnt": "exceptions",
+    "sleepcnt": "sleep",
+    "lsucnt": "lsu",
+    "foldcnt": "fold",
+}
+
+TEST_RE = re.compile(r"\[TEST\] (?P<test>\S+)")
+KERNEL_RE = re.compile(
+    r"\[KERNEL\]\[(?P<kernel>\w+)\] (?P<us>\d+)(?: cycles=(?P<cycles>\d+))?(?: depth=\d+)?"
+    r"(?: cache=(?P<cache>cold|warm))?"
+)
+CACHE_RE = re.compile(r"\bCache=(cold|warm)\b")
+PMU_RE = re.compile(r"\[PMU\]\[(?P<kernel>\w+)\] group=\d+ (?P<fields>.*)$")
+REPEAT_RE = re.compile(r"\[REPEAT\]\[(?P<kernel>\w+)\] (?P<fields>.*)$")
+SHAPE_RE = re.compile(r"\[SHAPE\]\[(?P<kernel>\w+)\] .*\bmacs=(?P<macs>\d+) bytes=(?P<bytes>\d+) peak=(?P<peak>\d+)")
+HELPER_RE = re.compile(
+    r"\[HELPER\]\[(?P<helper>\w+)\] parent=(?P<parent>\w+) calls=(?P<calls>\d+) cycles=(?P<cycles>\d+)"
+)
+STATS_BEGIN_RE = re.compile(r"\[STATS\] begin label=(?P<label>\S+) buckets=\d+ log2=(?P<log2>\d+)")
+STATS_RE = re.compile(
+    r"\[STATS\]\[(?P<kernel>\w+)\] n=(?P<n>\d+) sum=(?P<sum>\d+) min=(?P<min>\d+) max=(?P<max>\d+) "
+    r"sumsq=(?P<sumsq>\d+) hist=(?P<hist>[\d,]*)"
+)
+TEST_TIME_RE = re.compile(r"\[(?P<kind>TEST_TIME|SUITE)\] (?:(?P<test>[^\s=]+) )?(?P<fields>\w+=.*)$")
+COUNT_RE = re.compile(r"\[COUNT\]\[(?P<kernel>\w+)\] calls=(?P<calls>\d+)")
+WRAPPER_RE = re.compile(r"^(?P<kernel>arm_\w+), Status=\w+\((?P<status>-?\d+)\), (?P<fields>.*)$")
+FIELD_RE = re.compile(r"(\w+)=(-?\d+)")
+
+SCHEMA = """
+CREATE TABLE IF NOT EXISTS runs (
+    id      INTEGER PRIMARY KEY,
+    label   TEXT NOT NULL UNIQUE,
+    created TEXT NOT NULL,
+    source  TEXT
+);
+CREATE TABLE IF NOT EXISTS samples (
+    run_id INTEGER NOT NULL REFERENCES runs(id) ON DELETE CASCADE,
+    test   TEXT NOT NULL,
+    kernel TEXT NOT NULL,
+    metric TEXT NOT NULL,
+    value  REAL NOT NULL
+);
+CREATE INDEX IF NOT EXISTS samples_key ON samples (test, kernel, metric, run_id);
+"""
+
+
+# --------------------------------------------------------------------------- #
+# Log parsing
+# --------------------------------------------------------------------------- #
+
+
+def cache_penalty(cold, kernel, cache, values):
+    """ColdPenalty_* metrics for a warm call, from the cold call of the same kernel just before it."""
+    if cache == "cold":
+        cold[kernel] = values
+        return
+    first = cold.pop(kernel, None) if cache == "warm" else None
+    if first is None:
+        return
+    for metric, name in (("time_us", "ColdPenalty_us"), ("cycles", "ColdPenalty_cycles")):
+        if metric in first and metric in values:
+            yield name, first[metric] - values[metric]
+
+
+def shape_metrics(macs, nbytes, peak):
+    """Stored metrics for one [SHAPE] record: work per call and the MVE peak it is measured against."""
+    return (("macs", macs), ("bytes", nbytes), ("peak_macs", peak))
+
+
+def parse_text(lines):
+    """Yield (test, kernel, metric, value) from wrapper text and [KERNEL] lines.
+
+    Calls measured by the cache modes get a _cold/_warm metric suffix.
+    """
+    test = ""
+    cold = {}
+    for line in lines:
+        m = TEST_RE.search(line)
+        if m:
+            test = m.group("test")
+            continue
+        m = KERNEL_RE.search(line)
+        if m:
+            cache = m.group("cache")
+            values = {"time_us": int(m.group("us"))}
+            if m.group("cycles"):
+                values["cycles"] = int(m.group("cycles"))
+            for metric, value in values.items():
+                yield test, m.group("kernel"), metric + (f"_{cache}" if cache else ""), value
+            for metric, value in cache_penalty(cold, m.group("kernel"), cache, values):
+                yield test, m.group("kernel"), metric, value
+            continue
+        m = PMU_RE.search(line)
+        if m:
+            for key, value in FIELD_RE.findall(m.group("fields")):
+                yield test, m.group("kernel"), key, int(value)
+            continue
+        m = REPEAT_RE.search(line)
+        if m:
+            for key, value in FIELD_RE.findall(m.group("fields")):
+                yield test, m.group("kernel"), "repeat_" + key, int(value)
+            continue
+        m = SHAPE_RE.search(line)
+        if m:
+            for metric, value in shape_metrics(int(m.group("macs")), int(m.group("bytes")), int(m.group("peak"))):
+                yield test, m.group("kernel"), metric, value
+            continue
+        m = HELPER_RE.search(line)
+        if m:
+            kernel = f"{m.group('parent')}/{m.group('helper')}"
+            yield test, kernel, "helper_calls", int(m.group("calls"))
+            yield test, kernel, "cycles", int(m.group("cycles"))
+            continue
+        m = WRAPPER_RE.search(line.strip())
+        if m:
+            c = CACHE_RE.search(m.group("fields"))
+            cache = c.group(1) if c else None
+            values = {}
+            for key, value in FIELD_RE.findall(m.group("fields")):
+                if key == "Depth":
+                    continue
+                base, corr, _ = key.partition("_corr")
+                values[TEXT_METRICS.get(base, base) + corr] = int(value)
+            for metric, value in values.items():
+                yield test, m.group("kernel"), metric + (f"_{cache}" if cache else ""), value
+            for metric, value in cache_penalty(cold, m.group("kernel"), cache, values):
+                yield test, m.group("kernel"), metric, value
+
+
+def parse_trace(lines, names, helpers=()):
+    """Yield (test, kernel, metric, value) from [TRACE] blocks."""
+    for rec in trace_decode.decode(lines, names, helpers):
+        test, kernel = rec["test"], rec["kernel"]
+        if rec.get("helper"):
+            kernel = f"{rec.get('parent', '')}/{kernel}"
+            yield test, kernel, "helper_calls", rec["calls"]
+            yield test, kernel, "cycles", rec["cycles"]
+            continue
+        if rec["flags"] & trace_decode.STATS:
+            for key, value in rec.items():
+                if key.startswith("repeat_"):
+                    yield test, kernel, key, value
+            continue
+        if rec["flags"] & trace_decode.PMU_GROUP:
+            for key, value in rec.items():
+                if key[:1].isupper():
+                    yield test, kernel, key, value
+            continue
+        if "shape" in rec:
+            m = SHAPE_RE.search(f"[SHAPE][{kernel}] {rec['shape']}")
+            for metric, value in shape_metrics(int(m.group("macs")), int(m.group("bytes")), int(m.group("peak"))):
+                yield test, kernel, metric, value
+        if rec["flags"] & trace_decode.SHAPE:
+            continue
+        cache = f"_{rec['cache']}" if "cache" in rec else ""
+        yield test, kernel, "time_us" + cache, rec["time_us"]
+        if "cycles" in rec:
+            yield test, kernel, "cycles" + cache, rec["cycles"]
+        for key, value in rec.items():
+            if key.startswith("ColdPenalty_"):
+                yield test, kernel, key, value
+        for suffix in ("", "_corr"):
+            if "cyccnt" + suffix not in rec:
+                continue
+            for field, metric in TRACE_METRICS.items():
+                yield test, kernel, metric + suffix + cache, rec[field + suffix]
+            yield test, kernel, "instructions" + suffix + cache, trace_decode.dwt_instructions(rec, suffix)
+        # Exclusive values of calls with nested wrapped calls
+        if "cycles_excl" in rec:
+            yield test, kernel, "cycles_excl" + cache, rec["cycles_excl"]
+        for field, metric in TRACE_METRICS.items():
+            if field != "cyccnt" and field + "_excl" in rec:
+                yield test, kernel, metric + "_excl" + cache, rec[field + "_excl"]
+        for key, value in rec.items():
+            if key[:1].isupper() and not key.startswith("ColdPenalty_"):
+                yield test, kernel, key + cache, value
+
+
+def parse_counts(lines):
+    """Yield (test, kernel, "calls", n) from the [COUNT] lines of kernels at the call-count level, and the
+    (test, "*", "test_<field>", value) phase breakdown of each [TEST_TIME] line ("suite_<field>" for [SUITE])."""
+    test = ""
+    for line in lines:
+        m = TEST_RE.search(line)
+        if m:
+            test = m.group("test")
+            continue
+        m = COUNT_RE.search(line)
+        if m:
+            yield test, m.group("kernel"), "calls", int(m.group("calls"))
+            continue
+        m = TEST_TIME_RE.search(line)
+        if m:
+            suite = m.group("kind") == "SUITE"
+            fields = m.group("fields")
+            for key, value in FIELD_RE.findall(fields):
+                yield ("suite" if suite else m.group("test")), "*", ("suite_" if suite else "test_") + key, int(value)
+            if not suite:
+                yield m.group("test"), "*", "test_failed", int("result=PASS" not in fields)
+
+
+def hist_percentile(hist, log2, lo, hi, pct):
+    """Cycles at percentile pct of a [STATS] log2 histogram, interpolated geometrically within the bucket."""
+    total = sum(hist)
+    rank = pct / 100.0 * total
+    seen = 0
+    for b, count in enumerate(hist):
+        if count and seen + count >= rank:
+            low = lo if b == 0 else max(lo, 2 ** (b + log2))
+            high = hi if b == len(hist) - 1 else min(hi, 2 ** (b + 1 + log2))
+            frac = (rank - seen) / count
+            return low * (high / low) ** frac if low > 0 else high * frac
+        seen += count
+    return float(hi)
+
+
+def stats_metrics(m, log2):
+    """Stored metrics for one [STATS] line: the aggregates plus mean, stddev and histogram percentiles."""
+    n, total, lo, hi = int(m.group("n")), int(m.group("sum")), int(m.group("min")), int(m.group("max"))
+    mean = total / n
+    var = max(int(m.group("sumsq")) / n - mean * mean, 0.0) * n / (n - 1) if n > 1 else 0.0
+    hist = [int(v) for v in m.group("hist").split(",") if v]
+    yield "stats_n", n
+    yield "stats_mean", mean
+    yield "stats_min", lo
+    yield "stats_max", hi
+    yield "stats_stddev", math.sqrt(var)
+    for pct in (50, 90, 99):
+        yield f"stats_p{pct}", hist_percentile(hist, log2, lo, hi, pct)
+
+
+def parse_stats(lines):
+    """Yield (label, kernel, metric, value) from [STATS] dumps; the dump label stands in for the test."""
+    label, log2 = "", 0
+    for line in lines:
+        m = STATS_BEGIN_RE.search(line)
+        if m:
+            label, log2 = m.group("label"), int(m.group("log2"))
+            continue
+        m = STATS_RE.search(line)
+        if m:
+            for metric, value in stats_metrics(m, log2):
+                yield label, m.group("kernel"), metric, value
+
+
+def parse_log(lines, header):
+    lines = list(lines)
+    counts = list(parse_counts(lines)) + list(parse_stats(lines))
+    if any("[TRACE] begin" in line for line in lines):
+        names = trace_decode.load_kernel_names(header)
+        return list(parse_trace(lines, names, trace_decode.load_helper_names(header))) + counts
+    return list(parse_text(lines)) + counts
+
+
+# --------------------------------------------------------------------------- #
+# Statistics
+# --------------------------------------------------------------------------- #
+
+
+def mann_whitney_greater(a, b):
+    """One-sided p-value that samples b are stochastically larger than a.
+
+    Normal approximation with tie and continuity correction; adequate for the
+    handful-to-hundreds of repeats a harness run produces.
+    """
+    n1, n2 = len(a), len(b)
+    if n1 == 0 or n2 == 0:
+        return 1.0
+    pooled = sorted([(v, 0) for v in a] + [(v, 1) for v in b])
+    ranks = [0.0] * len(pooled)
+    tie_term = 0.0
+    i = 0
+    while i < len(pooled):
+        j = i
+        while j + 1 < len(pooled) and pooled[j + 1][0] == pooled[i][0]:
+            j += 1
+        rank = (i + j) / 2.0 + 1.0
+        for k in range(i, j + 1):
+            ranks[k] = rank
+        t = j - i + 1
+        tie_term += t**3 - t
+        i = j + 1
+    r2 = sum(r for r, (_, g) in zip(ranks, pooled) if g == 1)
+    u2 = r2 - n2 * (n2 + 1) / 2.0
+    mu = n1 * n2 / 2.0
+    n = n1 + n2
+    var = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1))) if n > 1 else 0.0
+    if var <= 0.0:
+        # All values identical
+        return 1.0 if u2 <= mu else 0.0
+    z = (u2 - mu - 0.5) / math.sqrt(var)
+    return 0.5 * math.erfc(z / math.sqrt(2.0))
+
+
+def changepoints(series, min_size=3, penalty=None):
+    """Binary segmentation on a mean-shift cost; returns split indices.
+
+    A split is kept when it lowers the squared-error cost by more than
+    `penalty` (BIC-style, scaled by the series' robust noise estimate).
+    """
+    n = len(series)
+    if n < 2 * min_size:
+        return []
+    if penalty is None:
+        diffs = [abs(series[i + 1] - series[i]) for i in range(n - 1)]
+        sigma = statistics.median(diffs) / 0.6745 / math.sqrt(2.0) if diffs else 0.0
+        penalty = 2.0 * math.log(n) * max(sigma, 1e-9) ** 2
+
+    def cost(lo, hi):
+        seg = series[lo:hi]
+        mean = sum(seg) / len(seg)
+        return sum((x - mean) ** 2 for x in seg)
+
+    found = []
+    stack = [(0, n)]
+    while stack:
+        lo, hi = stack.pop()
+        if hi - lo < 2 * min_size:
+            continue
+        whole = cost(lo, hi)
+        best, best_gain = None, 0.0
+        for k in range(lo + min_size, hi - min_size + 1):
+            gain = whole - cost(lo, k) - cost(k, hi)
+            if gain > best_gain:
+                best, best_gain = k, gain
+        if best is not None and best_gain > penalty:
+            found.append(best)
+            stack += [(lo, best), (best, hi)]
+    return sorted(found)
+
+
+# --------------------------------------------------------------------------- #
+# Commands
+# --------------------------------------------------------------------------- #
+
+
+def open_db(path):
+    db = sqlite3.connect(path)
+    db.execute("PRAGMA foreign_keys = ON")
+    db.executescript(SCHEMA)
+    return db
+
+
+def cmd_ingest(db, args):
+    stream = sys.stdin if args.log == "-" else open(args.log, errors="replace")
+    with stream:
+        samples = parse_log(stream, args.header)
+    if not samples:
+        raise SystemExit("no kernel records found in input")
+    if args.replace:
+        db.execute("DELETE FROM runs WHERE label = ?", (args.label,))
+    created = datetime.now(timezone.utc).isoformat(timespec="seconds")
+    cur = db.execute(
+        "INSERT INTO runs (label, created, source) VALUES (?, ?, ?)", (args.label, created, args.log)
+    )
+    db.executemany(
+        "INSERT INTO samples (run_id, test, kernel, metric, value) VALUES (?, ?, ?, ?, ?)",
+        [(cur.lastrowid, *s) for s in samples],
+    )
+    db.commit()
+    keys = {(t, k) for t, k, _, _ in samples}
+    print(f"run '{args.label}': {len(samples)} samples over {len(keys)} test/kernel pairs")
+
+
+def cmd_runs(db, args):
+    for run_id, label, created, source, count in db.execute(
+        "SELECT r.id, r.label, r.created, r.source, COUNT(s.rowid) FROM runs r "
+        "LEFT JOIN samples s ON s.run_id = r.id GROUP BY r.id ORDER BY r.id"
+    ):
+        print(f"{run_id:4d}  {label:24s} {created}  {count:7d} samples  {source}")
+
+
+def run_samples(db, label, metrics):
+    row = db.execute("SELECT id FROM runs WHERE label = ?", (label,)).fetchone()
+    if row is None:
+        raise SystemExit(f"unknown run label '{label}'")
+    out = {}
+    marks = ",".join("?" * len(metrics))
+    for test, kernel, metric, value in db.execute(
+        f"SELECT test, kernel, metric, value FROM samples WHERE run_id = ? AND metric IN ({marks})",
+        (row[0], *metrics),
+    ):
+        out.setdefault((test, kernel, metric), []).append(value)
+    return out
+
+
+def cmd_gate(db, args):
+    metrics = args.metric or list(GATED_METRICS)
+    base = run_samples(db, args.baseline, metrics)
+    cand = run_samples(db, args.candidate, metrics)
+    regressions, improvements, compared = [], [], 0
+    for key in sorted(base.keys() & cand.keys()):
+        a, b = base[key], cand[key]
+        ma, mb = statistics.median(a), statistics.median(b)
+        if ma <= 0:
+            continue
+        compared += 1
+        change = (mb - ma) / ma
+        if len(a) >= args.min_repeats and len(b) >= args.min_repeats:
+            p_worse = mann_whitney_greater(a, b)
+            p_better = mann_whitney_greater(b, a)
+        else:
+            # Too few repeats for a rank test; rely on the threshold alone
+            p_worse = p_better = 0.0
+        row = (key, ma, mb, change, min(p_worse, p_better), len(a), len(b))
+        if change > args.threshold and p_worse < args.alpha:
+            regressions.append(row)
+        elif change < -args.threshold and p_better < args.alpha:
+            improvements.append(row)
+
+    def report(title, rows):
+        print(f"\n{title} ({len(rows)})")
+        print(f"  {'test':48s} {'kernel':34s} {'metric':18s} {'base':>12s} {'cand':>12s} {'delta':>8s} {'p':>7s}")
+        for (test, kernel, metric), ma, mb, change, p, _, _ in rows:
+            print(
+                f"  {test:48s} {kernel:34s} {metric:18s} {ma:12.0f} {mb:12.0f} {change * 100:+7.2f}% {p:7.4f}"
+            )
+
+    print(f"compared {compared} test/kernel/metric series: {args.baseline} -> {args.candidate}")
+    missing = sorted({k[:2] for k in base.keys() - cand.keys()})
+    if missing:
+        print(f"{len(missing)} test/kernel pairs missing from candidate")
+    if improvements:
+        report("improvements", improvements)
+    if regressions:
+        report("REGRESSIONS", regressions)
+        sys.exit(1)
+    print("\nno regressions")
+
+
+def cmd_changepoints(db, args):
+    query = (
+        "SELECT r.id, r.label, s.test, s.kernel, s.value FROM samples s JOIN runs r ON r.id = s.run_id "
+        "WHERE s.metric = ?"
+    )
+    params = [args.metric]
+    if args.kernel:
+        query += " AND s.kernel = ?"
+        params.append(args.kernel)
+    if args.test:
+        query += " AND s.test = ?"
+        params.append(args.test)
+    per_run = {}
+    labels = {}
+    for run_id, label, test, kernel, value in db.execute(query + " ORDER BY r.id", params):
+        labels[run_id] = label
+        per_run.setdefault((test, kernel), {}).setdefault(run_id, []).append(value)
+
+    hits = 0
+    for (test, kernel), runs in sorted(per_run.items()):
+        run_ids = sorted(runs)
+        series = [statistics.median(runs[r]) for r in run_ids]
+        for idx in changepoints(series, min_size=args.min_size):
+            before = statistics.median(series[max(0, idx - args.min_size) : idx])
+            after = statistics.median(series[idx : idx + args.min_size])
+            if before and abs(after - before) / before < args.threshold:
+                continue
+            hits += 1
+            print(
+                f"{test:48s} {kernel:34s} {args.metric}: {before:.0f} -> {after:.0f} "
+                f"({(after - before) / before * 100:+.2f}%) at run '{labels[run_ids[idx]]}'"
+            )
+    if not hits:
+        print("no change points found")
+
+
+# Cycle metrics a roofline point is computed from, most trustworthy first
+ROOFLINE_CYCLES = ("cycles_corr", "cycles", "cycles_corr_warm", "cycles_warm")
+
+
+def cmd_roofline(db, args):
+    metrics = ["macs", "bytes", "peak_macs", *ROOFLINE_CYCLES]
+    samples = run_samples(db, args.run, metrics)
+    per_key = {}
+    for (test, kernel, metric), values in samples.items():
+        per_key.setdefault((test, kernel), {})[metric] = statistics.median(values)
+
+    print(f"run '{args.run}', memory bandwidth {args.bandwidth:g} bytes/cycle")
+    print(
+        f"{'test':48s} {'kernel':34s} {'MACs':>10s} {'bytes':>10s} {'cycles':>10s} "
+        f"{'MAC/cyc':>8s} {'%peak':>6s} {'B/cyc':>6s} {'MAC/B':>7s}  bound"
+    )
+    for (test, kernel), m in sorted(per_key.items()):
+        if "bytes" not in m:
+            continue
+        cycles = next((m[c] for c in ROOFLINE_CYCLES if c in m), None)
+        macs, nbytes, peak = m["macs"], m["bytes"], m.get("peak_macs", 0)
+        intensity = macs / nbytes if nbytes else 0.0
+        if cycles:
+            mac_rate = f"{macs / cycles:8.3f}"
+            pct = f"{100.0 * macs / cycles / peak:6.1f}" if peak else f"{'-':>6s}"
+            byte_rate = f"{nbytes / cycles:6.2f}"
+            shown = f"{cycles:10.0f}"
+        else:
+            # No cycle count was logged for this call
+            mac_rate, pct, byte_rate, shown = f"{'-':>8s}", f"{'-':>6s}", f"{'-':>6s}", f"{'-':>10s}"
+        # Ridge point: intensity at which the bandwidth roof meets the compute roof
+        bound = "compute" if peak and intensity >= peak / args.bandwidth else "memory"
+        print(
+            f"{test:48s} {kernel:34s} {macs:10.0f} {nbytes:10.0f} {shown} "
+            f"{mac_rate} {pct} {byte_rate} {intensity:7.2f}  {bound}"
+        )
+
+
+def main(argv=None):
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--db", default=DEFAULT_DB, help=f"SQLite database (default {DEFAULT_DB})")
+    sub = ap.add_subparsers(dest="cmd", required=True)
+
+    p = sub.add_parser("ingest", help="store a captured log as a run")
+    p.add_argument("log", help="captured log file, or - for stdin")
+    p.add_argument("--label", required=True, help="run label, e.g. a git describe of the firmware")
+    p.add_argument("--replace", action="store_true", help="overwrite an existing run with this label")
+    p.add_argument("--header", default=trace_decode.DEFAULT_HEADER, help="kernel_timing_wrap.h for [TRACE] logs")
+    p.set_defaults(func=cmd_ingest)
+
+    p = sub.add_parser("runs", help="list stored runs")
+    p.set_defaults(func=cmd_runs)
+
+    p = sub.add_parser("gate", help="fail if candidate regressed against baseline")
+    p.add_argument("--baseline", required=True)
+    p.add_argument("--candidate", required=True)
+    p.add_argument("--metric", action="append", help=f"metric to gate (default {', '.join(GATED_METRICS)})")
+    p.add_argument("--threshold", type=float, default=0.02, help="minimum relative change (default 0.02)")
+    p.add_argument("--alpha", type=float, default=0.01, help="Mann-Whitney significance (default 0.01)")
+    p.add_argument("--min-repeats", type=int, default=5, help="repeats per side needed for the rank test")
+    p.set_defaults(func=cmd_gate)
+
+    p = sub.add_parser("changepoints", help="find level shifts across stored runs")
+    p.add_argument("--metric", default="cycles")
+    p.add_argument("--kernel")
+    p.add_argument("--test")
+    p.add_argument("--min-size", type=int, default=3, help="minimum runs on each side of a change")
+    p.add_argument("--threshold", type=float, default=0.02, help="ignore shifts smaller than this")
+    p.set_defaults(func=cmd_changepoints)
+
+    p = sub.add_parser("roofline", help="MACs/cycle and arithmetic intensity per kernel call")
+    p.add_argument("--run", required=True, help="run label")
+    p.add_argument("--bandwidth", type=float, default=8.0, help="sustained memory bytes/cycle (default 8)")
+    p.set_defaults(func=cmd_roofline)
+
+    args = ap.parse_args(argv)
+    with open_db(Path(args.db)) as db:
+        args.func(db, args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+"""Report and compare the per-kernel instruction counts of the QEMU build.
+
+Reads the [QEMU_INSN] lines that qemu/plugin/kernel_insns.c writes (one per
+kernel call: test index, call sequence within the test, kernel id, nesting
+depth, instructions, MVE instructions, loads, stores) and names the test and
+kernel from the headers the image was built with.
+
+    python3 tools/qemu_insns.py report qemu/build/insns.log
+    python3 tools/qemu_insns.py report --csv qemu/build/shards/insns.log > insns.csv
+    python3 tools/qemu_insns.py diff base.log qemu/build/shards/insns.log
+
+The counts are deterministic for a given image, so `diff` is a regression
+check: it matches calls by (test, seq, kernel), prints every count that moved
+by more than --threshold percent (default 0: any change), and every call that
+appeared or disappeared, and exits non-zero if there was any.
+"""
+
+import argparse
+import csv
+import re
+import sys
+
+import result_store
+import trace_decode
+
+LINE_RE = re.compile(
+    r"\[QEMU_INSN\] test=(?P<test>\d+) seq=(?P<seq>\d+) kernel=(?P<kernel>\d+) depth=(?P<depth>\d+)"
+    r" insns=(?P<insns>\d+) mve=(?P<mve>\d+) loads=(?P<loads>\d+) stores=(?P<stores>\d+)"
+)
+COUNTS = ("insns", "mve", "loads", "stores")
+
+
+def load(path, tests, kernels):
+    """(test, seq, kernel) -> record, in log order."""
+    recs = {}
+    with (sys.stdin if path == "-" else open(path, errors="replace")) as stream:
+        for line in stream:
+            m = LINE_RE.search(line)
+            if not m:
+                continue
+            rec = {k: int(v) for k, v in m.groupdict().items()}
+            t, k = rec["test"], rec["kernel"]
+            rec["test_name"] = tests[t] if t < len(tests) else f"test_{t}"
+            rec["kernel_name"] = kernels[k] if k < len(kernels) else f"kernel_{k}"
+            recs[(t, rec["seq"], k)] = rec
+    return recs
+
+
+def format_rec(rec):
+    mve_pct = 100.0 * rec["mve"] / rec["insns"] if rec["insns"] else 0.0
+    return (f"{'  ' * rec['depth']}{rec['kernel_name']} insns={rec['insns']} mve={rec['mve']} ({mve_pct:.1f}%)"
+            f" loads={rec['loads']} stores={rec['stores']}")
+
+
+def report(recs, as_csv):
+    if as_csv:
+        fields = ["test_name", "seq", "kernel_name", "depth", *COUNTS]
+        writer = csv.DictWriter(sys.stdout, fieldnames=fields, extrasaction="ignore")
+        writer.writeheader()
+        writer.writerows(recs.values())
+        return
+    test = None
+    for rec in recs.values():
+        if rec["test"] != test:
+            test = rec["test"]
+            print(f"[TEST] {rec['test_name']}")
+        print(format_rec(rec))
+
+
+def diff(base, new, threshold):
+    changes = 0
+    for key in sorted(base.keys() | new.keys()):
+        b, n = base.get(key), new.get(key)
+        rec = n or b
+        where = f"{rec['test_name']} #{rec['seq']} {rec['kernel_name']}"
+        if not b or not n:
+            print(f"[{'ADDED' if n else 'REMOVED'}] {where} insns={rec['insns']}")
+            changes += 1
+            continue
+        moved = []
+        for field in COUNTS:
+            if b[field] == n[field]:
+                continue
+            pct = 100.0 * (n[field] - b[field]) / b[field] if b[field] else float("inf")
+            if abs(pct) > threshold:
+                moved.append(f"{field}={b[field]}->{n[field]} ({pct:+.1f}%)")
+        if moved:
+            print(f"[CHANGED] {where} {' '.join(moved)}")
+            changes += 1
+    print(f"[DIFF] base={len(base)} new={len(new)} calls, {changes} changed")
+    return changes
+
+
+def main(argv=None):
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--header", default=trace_decode.DEFAULT_HEADER, help="kernel_timing_wrap.h of the image")
+    ap.add_argument("--tests", default=result_store.DEFAULT_TESTS, help="test_library.h of the image")
+    sub = ap.add_subparsers(dest="cmd", required=True)
+    rp = sub.add_parser("report", help="print the counts per test and kernel call")
+    rp.add_argument("log", help="plugin output, or - for stdin")
+    rp.add_argument("--csv", action="store_true", help="emit CSV instead of text")
+    dp = sub.add_parser("diff", help="compare two runs; exit 1 if any count changed")
+    dp.add_argument("base")
+    dp.add_argument("new")
+    dp.add_argument("--threshold", type=float, default=0.0, help="ignore changes within this percentage")
+    args = ap.parse_args(argv)
+
+    tests = result_store.load_test_names(args.tests)
+    kernels = trace_decode.load_kernel_names(args.header)
+    if args.cmd == "report":
+        report(load(args.log, tests, kernels), args.csv)
+    else:
+        sys.exit(1 if diff(load(args.base, tests, kernels), load(args.new, tests, kernels), args.threshold) else 0)
+
+
+if __name__ == "__main__":
+    main()
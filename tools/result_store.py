@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""Decode the on-device result store (src/result_store.c).
+
+Reads either a captured log with the [STORE] block printed by
+result_store_dump() (the "store" command), or a raw image of the store: the
+host build's result_store.bin, or a debugger memory dump of the retained
+struct. Prints one line per record with run, test and kernel names, or CSV.
+The store is a ring that evicts its oldest runs when full; the count is
+reported, and runs cut short for lack of room report dropped records.
+The last [STORE] block in a log wins. Several stores (e.g. the per-shard
+files of tools/host_shards.py) are decoded one after the other.
+
+    python3 tools/result_store.py swo.log
+    python3 tools/result_store.py --csv result_store.bin > results.csv
+"""
+
+import argparse
+import csv
+import re
+import struct
+import sys
+from pathlib import Path
+
+import trace_decode
+
+REPO = Path(__file__).resolve().parent.parent
+DEFAULT_TESTS = REPO / "src" / "test_library.h"
+
+# Mirrors result_store_header_t and result_record_t
+HEADER = struct.Struct("<IHHIIIIIIIHH")
+RECORD = struct.Struct("<BBHIII")
+MAGIC = 0x53524B54
+VERSION = 2
+
+RUN, TEST, KERNEL = 1, 2, 3
+OUTCOMES = {0: "NOT_RUN", 1: "PASS", 2: "FAIL", 3: "TIMEOUT", 4: "RESET"}
+
+BEGIN_RE = re.compile(r"\[STORE\] begin\b")
+DATA_RE = re.compile(r"\[STORE\] (?P<hex>[0-9a-f]+)\s*$")
+END_RE = re.compile(r"\[STORE\] end\b")
+
+
+def load_test_names(header):
+    """Test index -> name, for the categories TEST_CATEGORIES builds in."""
+    text = Path(header).read_text()
+    block = re.search(r"#define TEST_CATEGORIES\s*\\\n((?:.*\\\n)*.*)", text)
+    if not block:
+        raise SystemExit(f"TEST_CATEGORIES not found in {header}")
+    names = []
+    for line in block.group(1).splitlines():
+        if "//" in line:
+            break
+        for cat in re.findall(r"CATEGORY\((\w+)\)", line):
+            lst = re.search(r"#define %s_TEST_LIST\s*\\\n((?:.*\\\n)*.*)" % cat, text)
+            names += re.findall(r"X\((\w+)", lst.group(1)) if lst else []
+    return names
+
+
+def read_store(path):
+    """(header fields, raw record bytes) from a raw image or the last [STORE] block of a log."""
+    raw = sys.stdin.buffer.read() if path == "-" else Path(path).read_bytes()
+    if len(raw) >= HEADER.size and HEADER.unpack_from(raw)[0] == MAGIC:
+        return HEADER.unpack_from(raw), raw[HEADER.size :]
+    blocks, cur = [], None
+    for line in raw.decode(errors="replace").splitlines():
+        if BEGIN_RE.search(line):
+            cur = []
+        elif END_RE.search(line):
+            if cur:
+                blocks.append(b"".join(cur))
+            cur = None
+        elif cur is not None:
+            m = DATA_RE.search(line)
+            if m:
+                cur.append(bytes.fromhex(m.group("hex")))
+    if not blocks:
+        raise SystemExit(f"no result store found in {path}")
+    return HEADER.unpack_from(blocks[-1]), blocks[-1][HEADER.size :]
+
+
+def records(hdr, body, tests, kernels):
+    """Yield one dict per record, stamped with the run it belongs to."""
+    magic, version, record_size, capacity, count, first, dropped, evicted, run_id, build, _, _ = hdr
+    if magic != MAGIC or version != VERSION or record_size != RECORD.size:
+        raise SystemExit(f"unsupported store: magic={magic:#x} version={version} record_size={record_size}")
+    slots = len(body) // RECORD.size
+    run, build_id = None, None
+    for i in range(count):
+        slot = (first + i) % capacity
+        if slot >= slots:
+            break  # truncated image
+        kind, code, test, a, b, c = RECORD.unpack_from(body, slot * RECORD.size)
+        if kind == RUN:
+            run, build_id = a, b
+            yield {"run": run, "build": f"{build_id:08x}", "record": "run", "tests": c}
+            continue
+        row = {"run": run, "build": f"{build_id:08x}" if build_id is not None else "", "test_index": test,
+               "test": tests[test] if test < len(tests) else f"test_{test}"}
+        if kind == TEST:
+            row.update(record="test", result=OUTCOMES.get(code, str(code)), cycles=a, kernel_cycles=b, failures=c)
+            if row["result"] == "RESET":  # c holds the reset status, not failures
+                row.update(failures=0, reset_status=f"{c:#010x}")
+        elif kind == KERNEL:
+            row.update(record="kernel", kernel=kernels[code] if code < len(kernels) else f"kernel_{code}",
+                       calls=a, cycles=b, max_cycles=c)
+        else:
+            row.update(record=f"kind_{kind}")
+        yield row
+
+
+def print_store(path, hdr, rows):
+    where = f" {path}" if path else ""
+    _, _, _, capacity, count, _, dropped, evicted, run_id, _, _, _ = hdr
+    print(f"[STORE]{where} records={count} capacity={capacity} dropped={dropped} evicted_runs={evicted} "
+          f"runs={run_id}")
+    if evicted:
+        print(f"warning:{where} the {evicted} oldest run(s) were evicted to make room", file=sys.stderr)
+    for row in rows:
+        if row["record"] == "run":
+            print(f"[RUN] {row['run']} build={row['build']} tests={row['tests']}")
+        elif row["record"] == "test":
+            print(f"[TEST] {row['test']} result={row['result']} cycles={row['cycles']} "
+                  f"kernel_cycles={row['kernel_cycles']} failures={row['failures']}"
+                  + (f" reset_status={row['reset_status']}" if "reset_status" in row else ""))
+        elif row["record"] == "kernel":
+            print(f"  [{row['kernel']}] calls={row['calls']} cycles={row['cycles']} max={row['max_cycles']}")
+
+
+def main(argv=None):
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("store", nargs="+", help="log with a [STORE] block, raw store image, or - for stdin")
+    ap.add_argument("--header", default=trace_decode.DEFAULT_HEADER, help="kernel_timing_wrap.h of the firmware")
+    ap.add_argument("--tests", default=DEFAULT_TESTS, help="test_library.h of the firmware")
+    ap.add_argument("--csv", action="store_true", help="emit CSV instead of text")
+    args = ap.parse_args(argv)
+
+    tests, kernels = load_test_names(args.tests), trace_decode.load_kernel_names(args.header)
+    stores = [(path, *read_store(path)) for path in args.store]
+    if args.csv:
+        fields = ["run", "build", "record", "test_index", "test", "result", "cycles", "kernel_cycles", "failures",
+                  "reset_status", "kernel", "calls", "max_cycles", "tests"]
+        writer = csv.DictWriter(sys.stdout, fieldnames=fields, restval="")
+        writer.writeheader()
+        for _, hdr, body in stores:
+            writer.writerows(records(hdr, body, tests, kernels))
+        return
+    for path, hdr, body in stores:
+        print_store(path if len(stores) > 1 else None, hdr, records(hdr, body, tests, kernels))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,449 @@
+#!/usr/bin/env python3
+"""Decode [TRACE] blocks emitted by kernel_trace_drain() in src/kernel_timing_wrap.c.
+
+Reads a captured SWO/UART log (file or stdin) and prints one line per wrapped
+kernel call in the same text format the wrappers print when built with
+KERNEL_TRACE_RING=0, so downstream tooling can consume either. When the log
+contains the [CALIB] line from kernel_timing_calibrate(), overhead-corrected
+*_corr values are reported next to the raw ones. In KERNEL_CACHE_COLD_WARM
+runs the warm record also carries ColdPenalty_us/ColdPenalty_cycles, and
+KERNEL_PMU_MULTIPLEX group re-runs are merged into the call they profile.
+Operand shape records are merged the same way and printed as a [SHAPE] line.
+Nested wrapped calls (dispatchers such as arm_convolve_wrapper_s8 calling
+arm_convolve_s8) are linked to their parent; parents gain *_excl exclusive
+values, and --tree/--folded print the per-test call tree. CMSIS-NN helper
+aggregates (KERNEL_HELPERS=1) become children of the call they ran under,
+printed as [HELPER] lines.
+
+    python3 tools/trace_decode.py swo.log
+    JLinkSWOViewerCL ... | python3 tools/trace_decode.py --csv -
+    python3 tools/trace_decode.py --folded swo.log | flamegraph.pl > calls.svg
+"""
+
+import argparse
+import csv
+import re
+import struct
+import sys
+from pathlib import Path
+
+REPO = Path(__file__).resolve().parent.parent
+DEFAULT_HEADER = REPO / "src" / "kernel_timing_wrap.h"
+
+# Mirrors kernel_trace_record_t (v1 had a 16-bit kernel id and no depth)
+RECORD = struct.Struct("<BBBbI6I8I")
+RECORD_V1 = struct.Struct("<HBbI6I8I")
+HAS_DWT = 0x01
+HAS_PMU = 0x02
+STATS = 0x04
+COLD = 0x08
+WARM = 0x10
+PMU_GROUP = 0x20
+SHAPE = 0x40
+CYCLES = 0x80
+
+# Mirrors kernel_shape_record_t, which shares the record slot size
+SHAPE_RECORD = struct.Struct("<BBBBII4I4I4H2B2B2B6x")
+SHAPE_RECORD_V1 = struct.Struct("<HBBII4I4I4H2B2B2B6x")
+
+# dwt[] of a STATS record: cycles over the repeat-mode re-runs of the previous call
+STATS_FIELDS = ("min", "median", "p90", "p99", "mean", "stddev")
+
+DWT_FIELDS = ("cyccnt", "cpicnt", "exccnt", "sleepcnt", "lsucnt", "foldcnt")
+# DWT field -> wrapper text label suffix
+TEXT_DWT = dict(zip(DWT_FIELDS, ("cycles", "cpi", "exceptions", "sleep", "lsu", "fold")))
+
+# ARMv8.1-M PMU event ids in the default KERNEL_PMU_EVENT_LIST
+PMU_EVENT_NAMES = {
+    0x0001: "L1I_CACHE_REFILL",
+    0x0003: "L1D_CACHE_REFILL",
+    0x0004: "L1D_CACHE",
+    0x0008: "INST_RETIRED",
+    0x0011: "CPU_CYCLES",
+    0x0013: "MEM_ACCESS",
+    0x0019: "BUS_ACCESS",
+    0x001D: "BUS_CYCLES",
+    0x0021: "BR_RETIRED",
+    0x0022: "BR_MIS_PRED_RETIRED",
+    0x0023: "STALL_FRONTEND",
+    0x0024: "STALL_BACKEND",
+    0x0100: "LE_RETIRED",
+    0x0108: "LE_CANCEL",
+    0x0200: "MVE_INST_RETIRED",
+    0x0228: "MVE_INT_MAC_RETIRED",
+    0x02CC: "MVE_STALL",
+    0x02CE: "MVE_STALL_RESOURCE_MEM",
+    0x02D4: "MVE_STALL_DEPENDENCY",
+    0x4005: "STALL_BACKEND_MEM",
+}
+
+BEGIN_RE = re.compile(r"\[TRACE\] begin (?P<fields>.*)$")
+DATA_RE = re.compile(r"\[TRACE\] (?P<hex>[0-9a-f]{%d})\s*$" % (2 * RECORD.size))
+END_RE = re.compile(r"\[TRACE\] end\b")
+CALIB_RE = re.compile(r"\[CALIB\] (?P<fields>.*)$")
+
+
+def load_kernel_names(header):
+    """Kernel id -> name, in KERNEL_LIST order."""
+    text = Path(header).read_text()
+    block = re.search(r"#define KERNEL_LIST\s*\\\n((?:.*\\\n)*.*)", text)
+    if not block:
+        raise SystemExit(f"KERNEL_LIST not found in {header}")
+    return re.findall(r"X\((\w+)", block.group(1))
+
+
+def load_helper_names(header):
+    """Helper id - kernel count -> name, in KERNEL_HELPER_LIST order."""
+    block = re.search(r"#define KERNEL_HELPER_LIST\s*\\\n((?:.*\\\n)*.*)", Path(header).read_text())
+    return re.findall(r"X\((\w+)", block.group(1)) if block else []
+
+
+def pmu_event_name(event_id):
+    return PMU_EVENT_NAMES.get(event_id, f"PMU_0x{event_id:04X}")
+
+
+def parse_fields(fields, pmu_base):
+    out = {}
+    for kv in fields.split():
+        key, _, value = kv.partition("=")
+        out[key] = value
+    out["pmu"] = [int(x, pmu_base) for x in out.get("pmu", "").split(",") if x]
+    return out
+
+
+def dwt_instructions(d, suffix=""):
+    return (
+        d["cyccnt" + suffix]
+        - d["cpicnt" + suffix]
+        - d["exccnt" + suffix]
+        - d["sleepcnt" + suffix]
+        - d["lsucnt" + suffix]
+        + d["foldcnt" + suffix]
+    ) & 0xFFFFFFFF
+
+
+def pmu_baselines(calib):
+    """Event id -> calibration baseline, from the [CALIB] pmu= list."""
+    if not calib:
+        return {}
+    events = [int(x, 16) for x in calib.get("events", "").split(",") if x]
+    return dict(zip(events, calib["pmu"]))
+
+
+def add_pmu(rec, event_ids, values, baselines):
+    for event_id, value in zip(event_ids, values):
+        if event_id:
+            rec[pmu_event_name(event_id)] = value
+            if event_id in baselines:
+                rec[pmu_event_name(event_id) + "_corr"] = max(value - baselines[event_id], 0)
+
+
+def dims(values):
+    return "x".join(str(v) for v in values)
+
+
+def format_shape(vals):
+    """Shape record fields -> the text the KERNEL_TRACE_RING=0 wrappers print after [SHAPE][kernel]."""
+    peak, macs, nbytes = vals[3:6]
+    inp, out, filt = vals[6:10], vals[10:14], vals[14:18]
+    stride, pad, dil = vals[18:20], vals[20:22], vals[22:24]
+    return (
+        f"in={dims(inp)} filter={dims(filt)} out={dims(out)} stride={dims(stride)} pad={dims(pad)} "
+        f"dilation={dims(dil)} macs={macs} bytes={nbytes} peak={peak}"
+    )
+
+
+def unpack(raw, version, layout, layout_v1):
+    """Record fields in the current layout; v1 records get depth 0 inserted after the kernel id."""
+    if version >= 2:
+        return layout.unpack(raw)
+    vals = layout_v1.unpack(raw)
+    return (vals[0], 0, *vals[1:])
+
+
+def records(lines, names, helpers=()):
+    """Yield one dict per record found in lines, PMU group re-runs included."""
+    block = None
+    calib = None
+    baselines = {}
+    cold = {}  # kernel -> last cold record, for the cold-start penalty of the warm one that follows
+    for line in lines:
+        m = CALIB_RE.search(line)
+        if m:
+            calib = parse_fields(m.group("fields"), 10)
+            baselines = pmu_baselines(calib)
+            continue
+        m = BEGIN_RE.search(line)
+        if m:
+            block = parse_fields(m.group("fields"), 16)
+            block["events"] = [int(x, 16) for x in block.get("events", "").split(",") if x]
+            if int(block.get("kernels", len(names))) != len(names):
+                print(
+                    f"warning: firmware has {block['kernels']} kernels, header has {len(names)}",
+                    file=sys.stderr,
+                )
+            if int(block.get("dropped", 0)):
+                print(
+                    f"warning: {block['dropped']} records dropped in test {block.get('test')}",
+                    file=sys.stderr,
+                )
+            continue
+        if block is None:
+            continue
+        if END_RE.search(line):
+            block = None
+            continue
+        m = DATA_RE.search(line)
+        if not m:
+            continue
+        raw = bytes.fromhex(m.group("hex"))
+        vals = unpack(raw, int(block.get("v", 1)), RECORD, RECORD_V1)
+        kernel_id, depth, flags, status, time_us = vals[:5]
+        dwt, pmu = vals[5:11], vals[11:19]
+        kernels = int(block.get("kernels", len(names)))
+        if kernel_id >= kernels:
+            # Helper aggregate: time_us = calls, dwt[0..2] = sum, min, max cycles
+            h = kernel_id - kernels
+            yield {
+                "test": block.get("test", ""),
+                "kernel": helpers[h] if h < len(helpers) else f"helper_{h}",
+                "helper": True,
+                "depth": depth,
+                "flags": flags,
+                "calls": time_us,
+                "cycles": dwt[0],
+                "cycles_min": dwt[1],
+                "cycles_max": dwt[2],
+            }
+            continue
+        kernel = names[kernel_id] if kernel_id < len(names) else f"kernel_{kernel_id}"
+        if flags & SHAPE:
+            shape = format_shape(unpack(raw, int(block.get("v", 1)), SHAPE_RECORD, SHAPE_RECORD_V1))
+            yield {"test": block.get("test", ""), "kernel": kernel, "depth": depth, "flags": flags, "shape": shape}
+            continue
+        if flags & STATS:
+            rec = {"test": block.get("test", ""), "kernel": kernel, "flags": flags, "repeat_n": time_us}
+            rec.update(("repeat_" + f, v) for f, v in zip(STATS_FIELDS, dwt))
+            yield rec
+            continue
+        if flags & PMU_GROUP:
+            size = int(block.get("groupsize", 0))
+            rec = {"test": block.get("test", ""), "kernel": kernel, "flags": flags, "pmu_group": time_us}
+            add_pmu(rec, block["events"][time_us * size : (time_us + 1) * size], pmu, baselines)
+            yield rec
+            continue
+        rec = {
+            "test": block.get("test", ""),
+            "kernel": kernel,
+            "depth": depth,
+            "status": status,
+            "time_us": time_us,
+            "flags": flags,
+        }
+        if flags & CYCLES:
+            rec["cycles"] = dwt[0]
+        if flags & HAS_DWT:
+            rec.update(zip(DWT_FIELDS, dwt))
+            if calib:
+                for field, value in zip(DWT_FIELDS, dwt):
+                    rec[field + "_corr"] = max(value - int(calib[field]), 0)
+        if flags & HAS_PMU:
+            add_pmu(rec, block["pmu"], pmu, baselines)
+        if flags & COLD:
+            rec["cache"] = "cold"
+            cold[kernel] = rec
+        elif flags & WARM:
+            rec["cache"] = "warm"
+            first = cold.pop(kernel, None)
+            if first is not None:
+                rec["ColdPenalty_us"] = first["time_us"] - time_us
+                key = "cyccnt" if "cyccnt" in rec else "cycles"
+                if key in rec and key in first:
+                    rec["ColdPenalty_cycles"] = first[key] - rec[key]
+        yield rec
+
+
+def inclusive_cycles(rec):
+    """Cycles of a call record: DWT cycles when counters were logged, else the time-only cycle count."""
+    return rec.get("cyccnt", rec.get("cycles"))
+
+
+def attribute(rec, nested):
+    """Attach the calls nested in rec and derive its exclusive values.
+
+    Records are logged when a call returns, so rec's children are the calls one
+    level deeper logged since the last call at rec's depth. A parent's counters
+    already exclude its children's instrumentation (see the shadow call stack in
+    kernel_timing_wrap.c); exclusive = parent - sum(children).
+    """
+    children = nested.pop(rec.get("depth", 0) + 1, [])
+    rec["children"] = children
+    for child in children:
+        child["parent"] = rec["kernel"]
+    nested.setdefault(rec.get("depth", 0), []).append(rec)
+    if not children:
+        return
+    incl = inclusive_cycles(rec)
+    if incl is not None and all(inclusive_cycles(c) is not None for c in children):
+        rec["cycles_excl"] = max(incl - sum(inclusive_cycles(c) for c in children), 0)
+    counters = [*DWT_FIELDS[1:], *(k for k in rec if k[:1].isupper() and not k.endswith("_corr"))]
+    for key in counters:
+        if key in rec and all(key in c for c in children):
+            rec[key + "_excl"] = max(rec[key] - sum(c[key] for c in children), 0)
+
+
+def decode(lines, names, helpers=()):
+    """Yield one dict per kernel call, with its shape and PMU group re-runs merged into one profile.
+
+    Call records also carry "children" (the calls nested in them) and *_excl
+    exclusive values when they have any.
+    """
+    pending = None
+    nested = {}  # depth -> calls not yet claimed by a parent
+    held = []  # helper aggregates, yielded once their parent call has claimed them
+    test = None
+    for rec in records(lines, names, helpers):
+        if rec["test"] != test:
+            test = rec["test"]
+            nested = {}
+        if rec.get("helper"):
+            attribute(rec, nested)
+            held.append(rec)
+            continue
+        if rec["flags"] & (PMU_GROUP | SHAPE) and pending is not None and pending["kernel"] == rec["kernel"]:
+            pending.update((k, v) for k, v in rec.items() if k[:1].isupper() or k == "shape")
+            continue
+        if pending is not None:
+            yield pending
+            pending = None
+        if rec["flags"] & (STATS | PMU_GROUP | SHAPE):
+            yield rec
+        else:
+            attribute(rec, nested)
+            yield from held
+            held = []
+            pending = rec
+    yield from held
+    if pending is not None:
+        yield pending
+
+
+def call_tree(recs):
+    """Per test: {call path: [calls, inclusive cycles, exclusive cycles]}, parents before children."""
+    trees = {}
+
+    def walk(rec, prefix, tree):
+        path = prefix + (rec["kernel"],)
+        incl = inclusive_cycles(rec) or 0
+        node = tree.setdefault(path, [0, 0, 0])
+        node[0] += rec.get("calls", 1) if rec.get("helper") else 1
+        node[1] += incl
+        node[2] += rec.get("cycles_excl", incl)
+        for child in rec["children"]:
+            walk(child, path, tree)
+
+    for rec in recs:
+        if "children" in rec and rec.get("depth", 0) == 0:
+            walk(rec, (), trees.setdefault(rec["test"], {}))
+    return trees
+
+
+def format_text(rec):
+    """Same line format as the KERNEL_TRACE_RING=0 wrappers."""
+    line = format_call(rec)
+    if "shape" in rec:
+        line += f"\n[SHAPE][{rec['kernel']}] {rec['shape']}"
+    return line
+
+
+def format_call(rec):
+    if rec.get("helper"):
+        return (
+            f"[HELPER][{rec['kernel']}] parent={rec.get('parent', '')} calls={rec['calls']} "
+            f"cycles={rec['cycles']} min={rec['cycles_min']} max={rec['cycles_max']}"
+        )
+    if rec["flags"] & SHAPE:
+        return f"[SHAPE][{rec['kernel']}] {rec['shape']}"
+    if rec["flags"] & STATS:
+        stats = " ".join(f"{f}={rec['repeat_' + f]}" for f in STATS_FIELDS)
+        return f"[REPEAT][{rec['kernel']}] n={rec['repeat_n']} {stats}"
+    if rec["flags"] & PMU_GROUP:
+        events = ", ".join(f"{k}={v}" for k, v in rec.items() if k[:1].isupper())
+        return f"[PMU][{rec['kernel']}] group={rec['pmu_group']} {events}, "
+    if not rec["flags"] & HAS_DWT:
+        line = f"[KERNEL][{rec['kernel']}] {rec['time_us']}"
+        line += f" cycles={rec['cycles']}" if "cycles" in rec else ""
+        line += f" depth={rec['depth']}" if rec.get("depth") else ""
+        line += f" cache={rec['cache']}" if "cache" in rec else ""
+        line += f" cycles_excl={rec['cycles_excl']}" if "cycles_excl" in rec else ""
+        extra = [f"{k}={v}" for k, v in rec.items() if k[:1].isupper()]
+        return line + (" " + ", ".join(extra) if extra else "")
+    status = "SUCCESS" if rec["status"] == 0 else "FAILURE"
+    parts = [rec["kernel"], f"Status={status}({rec['status']})", f"Time_us={rec['time_us']}"]
+    if rec.get("depth"):
+        parts.append(f"Depth={rec['depth']}")
+    if "cache" in rec:
+        parts.append(f"Cache={rec['cache']}")
+    for suffix in ("", "_corr"):
+        if "cyccnt" + suffix not in rec:
+            continue
+        parts += [
+            f"DWT_cycles{suffix}={rec['cyccnt' + suffix]}",
+            f"DWT_instructions{suffix}={dwt_instructions(rec, suffix)}",
+            f"DWT_cpi{suffix}={rec['cpicnt' + suffix]}",
+            f"DWT_exceptions{suffix}={rec['exccnt' + suffix]}",
+            f"DWT_sleep{suffix}={rec['sleepcnt' + suffix]}",
+            f"DWT_lsu{suffix}={rec['lsucnt' + suffix]}",
+            f"DWT_fold{suffix}={rec['foldcnt' + suffix]}",
+        ]
+    if "cycles_excl" in rec:
+        parts.append(f"DWT_cycles_excl={rec['cycles_excl']}")
+    parts += [f"DWT_{TEXT_DWT[f]}_excl={rec[f + '_excl']}" for f in DWT_FIELDS[1:] if f + "_excl" in rec]
+    parts += [f"{k}={v}" for k, v in rec.items() if k[:1].isupper()]
+    return ", ".join(parts) + ", "
+
+
+def main(argv=None):
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("log", help="captured log file, or - for stdin")
+    ap.add_argument("--header", default=DEFAULT_HEADER, help="kernel_timing_wrap.h the firmware was built with")
+    out = ap.add_mutually_exclusive_group()
+    out.add_argument("--csv", action="store_true", help="emit CSV instead of wrapper-format text")
+    out.add_argument("--tree", action="store_true", help="per-test call tree with inclusive/exclusive cycles")
+    out.add_argument("--folded", action="store_true", help="folded stacks of exclusive cycles, for flamegraph.pl")
+    args = ap.parse_args(argv)
+
+    names = load_kernel_names(args.header)
+    helpers = load_helper_names(args.header)
+    stream = sys.stdin if args.log == "-" else open(args.log, errors="replace")
+    with stream:
+        records = decode(stream, names, helpers)
+        if args.tree or args.folded:
+            for test, tree in call_tree(records).items():
+                if args.tree:
+                    print(f"[TREE] {test}")
+                for path, (calls, incl, excl) in tree.items():
+                    if args.folded:
+                        print(f"{';'.join((test, *path))} {excl}")
+                        continue
+                    parent = any(p[: len(path)] == path for p in tree if len(p) > len(path))
+                    share = f" ({100.0 * excl / incl:.1f}% exclusive)" if parent and incl else ""
+                    print(f"{'  ' * len(path)}{path[-1]} calls={calls} incl={incl} excl={excl}{share}")
+        elif args.csv:
+            rows = [{k: v for k, v in row.items() if k not in ("children", "helper")} for row in records]
+            fields = ["test", "kernel", "depth", "status", "time_us", "cycles", "flags", *DWT_FIELDS]
+            fields += sorted({k for row in rows for k in row} - set(fields))
+            writer = csv.DictWriter(sys.stdout, fieldnames=fields, restval="")
+            writer.writeheader()
+            writer.writerows(rows)
+        else:
+            test = None
+            for rec in records:
+                if rec["test"] != test:
+                    test = rec["test"]
+                    print(f"[TEST] {test}")
+                print(format_text(rec))
+
+
+if __name__ == "__main__":
+    main()